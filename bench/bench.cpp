@@ -0,0 +1,387 @@
+// bench.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// posix includes
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// biscotti includes
+#include "layout.hpp"
+#include "material.hpp"
+#include "settings.hpp"
+#include "slab.hpp"
+
+namespace
+{
+
+// A single benchmark problem: the reflector/core slab of decks/reference.deck
+// at a given resolution, optionally made scattering dominated or given a wider
+// core
+struct BenchCase
+{
+    std::string name;
+    unsigned int num_cells;
+    unsigned int num_groups;
+    unsigned int quadrature_order;
+    unsigned int downscatter_band;
+    Settings::AngularStorage storage;
+    Settings::Precision precision;
+    Settings::Scheme scheme;
+    unsigned int scattering_order;
+    bool diffusion_guess;
+    bool scattering_dominated;
+    Settings::Acceleration acceleration;
+    bool adaptive_inner_tol;
+    double core_width;
+    double tolerance;
+    unsigned int anderson_depth;
+    bool jfnk;
+    unsigned int num_threads;
+};
+
+// Energy (eV) of group g out of num_groups, fastest group first. Groups are
+// spaced logarithmically between the fast and thermal energies of the
+// reference deck.
+double GroupEnergy( unsigned int g, unsigned int num_groups )
+{
+    const double fast = 1.0e6;
+    const double thermal = 0.025;
+    if( num_groups == 1 )
+    {
+        return fast;
+    }
+    return fast * std::pow( thermal / fast, double( g ) / ( num_groups - 1 ) );
+}
+
+// Build a num_groups version of a reference deck material. Fast and thermal
+// values are interpolated over the groups, each group scatters into itself and
+// evenly into the next band slower groups, and fission neutrons are born in the
+// fastest group. Scattering moments 1 through scat_order are those of the
+// isotropic moment times mean_cosine^l.
+Material MakeMaterial( unsigned int num_groups, unsigned int band, double fast_abs, double thermal_abs, double fast_self_scat,
+        double fast_down_scat, double thermal_self_scat, double fast_fiss, double thermal_fiss,
+        double fast_nu, double thermal_nu, unsigned int scat_order, double mean_cosine )
+{
+    Material material;
+    for( unsigned int g = 0; g != num_groups; g++ )
+    {
+        const double x = num_groups == 1 ? 0.0 : double( g ) / ( num_groups - 1 );
+        const double energy = GroupEnergy( g, num_groups );
+        const bool last = g + 1 == num_groups;
+        material.SetMacroAbsXsec( energy, fast_abs + x * ( thermal_abs - fast_abs ) );
+        material.SetMacroScatXsec( energy, energy, last ? thermal_self_scat : fast_self_scat );
+        for( unsigned int to = 0; to != num_groups; to++ )
+        {
+            if( to != g )
+            {
+                const double value = to > g && to <= g + band ? fast_down_scat / band : 0.0;
+                material.SetMacroScatXsec( energy, GroupEnergy( to, num_groups ), value );
+            }
+        }
+        for( unsigned int l = 1; l <= scat_order; l++ )
+        {
+            const double factor = std::pow( mean_cosine, l );
+            material.SetMacroScatMoment( l, energy, energy, factor * ( last ? thermal_self_scat : fast_self_scat ) );
+            for( unsigned int to = g + 1; to <= g + band && to < num_groups; to++ )
+            {
+                material.SetMacroScatMoment( l, energy, GroupEnergy( to, num_groups ), factor * fast_down_scat / band );
+            }
+        }
+        material.SetMacroFissXsec( energy, fast_fiss + x * ( thermal_fiss - fast_fiss ) );
+        material.SetFissNu( energy, fast_nu + x * ( thermal_nu - fast_nu ) );
+        material.SetFissChi( energy, g == 0 ? 1.0 : 0.0 );
+        material.SetExtSource( energy, 0.0 );
+        material.AdjSetExtSource( energy, 0.0 );
+    }
+    return material;
+}
+
+// Build the reference deck layout with the given total number of cells. The
+// reflector keeps the reference ratio of 250 reflector cells to 6000 core cells.
+// The scattering dominated variant cuts reflector absorption by twenty and
+// scatters ten times more thermal neutrons in the core, so that source
+// iteration converges slowly.
+Layout MakeLayout( const BenchCase &bench_case )
+{
+    const unsigned int groups = bench_case.num_groups;
+    const unsigned int band = bench_case.downscatter_band;
+    const unsigned int order = bench_case.scattering_order;
+    const bool dominated = bench_case.scattering_dominated;
+    const double reflector_abs = dominated ? 0.05 : 1.0;
+    const double core_thermal_scat = dominated ? 10.0 : 1.0;
+    Material reflector = MakeMaterial( groups, band, reflector_abs * 0.025, reflector_abs * 0.05, 0.1125, 0.1125, 0.25,
+            0.0, 0.0, 1.0, 1.0, order, 0.5 );
+    Material core = MakeMaterial( groups, band, 0.075, 1.0, 0.049, 0.001, core_thermal_scat, 0.05, 6.0, 2.8, 2.5, order,
+            0.1 );
+    const unsigned int reflector_cells = std::max( 1u, bench_case.num_cells / 25 );
+    Layout layout;
+    layout.AddToEnd( reflector, 25.0, reflector_cells, 1.0, 1.0 );
+    layout.AddToEnd( core, bench_case.core_width, bench_case.num_cells - reflector_cells, 1.0, 1.0 );
+    return layout;
+}
+
+// Run one benchmark and print its result as a JSON object
+void RunCase( const BenchCase &bench_case )
+{
+    Settings settings;
+    settings.SetQuadratureOrder( bench_case.quadrature_order );
+    settings.SetAngularFluxStorage( bench_case.storage );
+    settings.SetAngularFluxPrecision( bench_case.precision );
+    settings.SetSpatialScheme( bench_case.scheme );
+    settings.SetScatteringOrder( bench_case.scattering_order );
+    settings.SetDiffusionGuess( bench_case.diffusion_guess );
+    settings.SetInnerAcceleration( bench_case.acceleration );
+    settings.SetAdaptiveInnerTol( bench_case.adaptive_inner_tol );
+    settings.SetKTol( bench_case.tolerance );
+    settings.SetSclFluxTol( bench_case.tolerance );
+    settings.SetAndersonDepth( bench_case.anderson_depth );
+    settings.SetNumThreads( bench_case.num_threads );
+    Layout layout = MakeLayout( bench_case );
+
+    // Discard solver progress and results while timing
+    std::streambuf *cout_buffer = std::cout.rdbuf( nullptr );
+
+    auto start = std::chrono::steady_clock::now();
+    Slab slab( settings, layout );
+    auto setup_end = std::chrono::steady_clock::now();
+    if( bench_case.jfnk )
+    {
+        slab.JfnkEigenvalueSolve();
+    }
+    else
+    {
+        slab.EigenvalueSolve();
+    }
+    auto solve_end = std::chrono::steady_clock::now();
+
+    std::cout.rdbuf( cout_buffer );
+
+    const double setup_time = std::chrono::duration<double>( setup_end - start ).count();
+    const double solve_time = std::chrono::duration<double>( solve_end - setup_end ).count();
+    const double updates = double( slab.NumSweeps() ) * slab.NumCells() * slab.NumGroups() * bench_case.quadrature_order;
+
+    struct rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+
+    std::cout.precision( 9 );
+    std::cout << "{ \"name\": \"" << bench_case.name << "\", ";
+    std::cout << "\"cells\": " << slab.NumCells() << ", ";
+    std::cout << "\"groups\": " << slab.NumGroups() << ", ";
+    std::cout << "\"quadrature_order\": " << bench_case.quadrature_order << ", ";
+    std::cout << "\"downscatter_band\": " << bench_case.downscatter_band << ", ";
+    std::cout << "\"angular_flux_storage\": \"" << ( bench_case.storage == Settings::EDGE ? "edge" : "full" ) << "\", ";
+    std::cout << "\"angular_flux_precision\": \"" << ( bench_case.precision == Settings::FLOAT ? "float" : "double" ) << "\", ";
+    std::cout << "\"spatial_scheme\": \"" << Settings::SchemeName( bench_case.scheme ) << "\", ";
+    std::cout << "\"scattering_order\": " << bench_case.scattering_order << ", ";
+    std::cout << "\"initial_guess\": \"" << ( bench_case.diffusion_guess ? "diffusion" : "flat" ) << "\", ";
+    std::cout << "\"scattering_dominated\": " << ( bench_case.scattering_dominated ? "true" : "false" ) << ", ";
+    std::cout << "\"inner_acceleration\": \"" << ( bench_case.acceleration == Settings::ANGULAR_MULTIGRID ?
+            "angular_multigrid" : "none" ) << "\", ";
+    std::cout << "\"inner_tolerance\": \"" << ( bench_case.adaptive_inner_tol ? "adaptive" : "fixed" ) << "\", ";
+    std::cout << "\"core_width_cm\": " << bench_case.core_width << ", ";
+    std::cout << "\"tolerance\": " << bench_case.tolerance << ", ";
+    std::cout << "\"anderson_depth\": " << bench_case.anderson_depth << ", ";
+    std::cout << "\"eigenvalue_solver\": \"" << ( bench_case.jfnk ? "jfnk" : "power" ) << "\", ";
+    std::cout << "\"threads\": " << bench_case.num_threads << ", ";
+    std::cout << "\"k\": " << slab.KEigenvalue() << ", ";
+    std::cout << "\"sweeps\": " << slab.NumSweeps() << ", ";
+    std::cout << "\"low_order_sweeps\": " << slab.NumLowOrderSweeps() << ", ";
+    std::cout << "\"setup_time_s\": " << setup_time << ", ";
+    std::cout << "\"wall_time_s\": " << solve_time << ", ";
+    std::cout << "\"sweeps_per_s\": " << slab.NumSweeps() / solve_time << ", ";
+    std::cout << "\"ns_per_update\": " << 1.0e9 * solve_time / updates << ", ";
+    std::cout << "\"bytes_per_cell\": " << double( slab.MemoryUsage() ) / slab.NumCells() << ", ";
+    std::cout << "\"peak_rss_kb\": " << usage.ru_maxrss << " }";
+    std::cout.flush();
+}
+
+// Canonical benchmark problems: the reference deck, then scaling series over
+// cell count, group count and quadrature order. The many-group series uses a
+// wider scattering band on a smaller mesh to exercise the scattering source.
+// The reference deck is also run storing only edge angular fluxes and storing
+// angular fluxes in single precision, and starting from the flat guesses
+// instead of a diffusion solution. The scheme series runs the reference deck
+// problem with diamond difference, linear discontinuous and step characteristic
+// on coarser meshes to compare time to solution at equal error. The scattering
+// order series adds forward peaked Legendre moments to the reference problem.
+// The acceleration series runs the reference and scattering dominated problems
+// with and without angular multigrid inner acceleration, and the inner tolerance
+// series runs them, also from the flat guesses, with fixed and adaptive inner
+// tolerances. The Anderson series widens the core to 200 cm, which raises the
+// dominance ratio, and converges it tightly with and without Anderson mixing of
+// the fission source. The JFNK series solves the wide core, reference and
+// scattering dominated problems by Jacobian free Newton Krylov instead of power
+// iteration. The threads series splits the per cell source updates and
+// convergence checks of the reference, many group and P5 scattering problems
+// over 1, 2 and 4 threads.
+std::vector<BenchCase> BenchCases()
+{
+    std::vector<BenchCase> cases;
+    cases.push_back( { "reference", 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE, Settings::DIAMOND_DIFFERENCE, 0,
+            true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    cases.push_back( { "reference_edge", 6250, 2, 64, 1, Settings::EDGE, Settings::DOUBLE, Settings::DIAMOND_DIFFERENCE, 0,
+            true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    cases.push_back( { "reference_float", 6250, 2, 64, 1, Settings::FULL, Settings::FLOAT, Settings::DIAMOND_DIFFERENCE, 0,
+            true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    cases.push_back( { "reference_flat_guess", 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE, Settings::DIAMOND_DIFFERENCE, 0,
+            false, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    const unsigned int cell_counts[] = { 625, 1250, 2500, 5000, 10000, 20000 };
+    for( unsigned int cells : cell_counts )
+    {
+        cases.push_back( { "cells_" + std::to_string( cells ), cells, 2, 16, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    }
+    const unsigned int group_counts[] = { 1, 2, 4, 8, 16 };
+    for( unsigned int groups : group_counts )
+    {
+        cases.push_back( { "groups_" + std::to_string( groups ), 1250, groups, 16, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    }
+    const unsigned int many_group_counts[] = { 50, 100, 200 };
+    for( unsigned int groups : many_group_counts )
+    {
+        cases.push_back( { "many_groups_" + std::to_string( groups ), 250, groups, 8, 8, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    }
+    const unsigned int orders[] = { 4, 8, 16, 32, 64, 128 };
+    for( unsigned int order : orders )
+    {
+        cases.push_back( { "order_" + std::to_string( order ), 1250, 2, order, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    }
+    const unsigned int scheme_cell_counts[] = { 250, 500, 1000, 2500, 5000 };
+    for( unsigned int cells : scheme_cell_counts )
+    {
+        cases.push_back( { "scheme_dd_" + std::to_string( cells ), cells, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+        cases.push_back( { "scheme_ld_" + std::to_string( cells ), cells, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::LINEAR_DISCONTINUOUS, 0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+        cases.push_back( { "scheme_sc_" + std::to_string( cells ), cells, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::STEP_CHARACTERISTIC, 0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    }
+    const unsigned int scattering_orders[] = { 1, 3, 5 };
+    for( unsigned int order : scattering_orders )
+    {
+        cases.push_back( { "scattering_p" + std::to_string( order ), 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, order, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, 1 } );
+    }
+    const Settings::Acceleration accelerations[] = { Settings::NONE, Settings::ANGULAR_MULTIGRID };
+    for( Settings::Acceleration acceleration : accelerations )
+    {
+        const std::string suffix = acceleration == Settings::NONE ? "_none" : "_angular_multigrid";
+        for( unsigned int order : { 64u, 128u } )
+        {
+            cases.push_back( { "acceleration_reference_s" + std::to_string( order ) + suffix, 6250, 2, order, 1,
+                    Settings::FULL, Settings::DOUBLE, Settings::DIAMOND_DIFFERENCE, 0, true, false, acceleration,
+                    false, 30.0, 1.0e-5, 0, false, 1 } );
+            cases.push_back( { "acceleration_scattering_s" + std::to_string( order ) + suffix, 6250, 2, order, 1,
+                    Settings::FULL, Settings::DOUBLE, Settings::DIAMOND_DIFFERENCE, 0, true, true, acceleration,
+                    false, 30.0, 1.0e-5, 0, false, 1 } );
+        }
+    }
+    for( bool adaptive : { false, true } )
+    {
+        const std::string suffix = adaptive ? "_adaptive" : "_fixed";
+        cases.push_back( { "inner_tol_reference" + suffix, 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, true, false, Settings::NONE, adaptive, 30.0, 1.0e-5, 0, false, 1 } );
+        cases.push_back( { "inner_tol_reference_flat_guess" + suffix, 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, false, false, Settings::NONE, adaptive, 30.0, 1.0e-5, 0, false, 1 } );
+        cases.push_back( { "inner_tol_scattering" + suffix, 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, true, true, Settings::NONE, adaptive, 30.0, 1.0e-5, 0, false, 1 } );
+        cases.push_back( { "inner_tol_scattering_flat_guess" + suffix, 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, false, true, Settings::NONE, adaptive, 30.0, 1.0e-5, 0, false, 1 } );
+    }
+    const unsigned int anderson_depths[] = { 0, 2, 3, 5 };
+    for( unsigned int depth : anderson_depths )
+    {
+        cases.push_back( { "anderson_wide_core_flat_guess_d" + std::to_string( depth ), 4000, 2, 16, 1, Settings::FULL,
+                Settings::DOUBLE, Settings::DIAMOND_DIFFERENCE, 0, false, false, Settings::NONE, false, 200.0, 1.0e-7,
+                depth, false, 1 } );
+        if( depth == 0 || depth == 3 )
+        {
+            cases.push_back( { "anderson_wide_core_d" + std::to_string( depth ), 4000, 2, 16, 1, Settings::FULL,
+                    Settings::DOUBLE, Settings::DIAMOND_DIFFERENCE, 0, true, false, Settings::NONE, false, 200.0,
+                    1.0e-7, depth, false, 1 } );
+        }
+    }
+    for( bool diffusion_guess : { true, false } )
+    {
+        const std::string suffix = diffusion_guess ? "" : "_flat_guess";
+        cases.push_back( { "jfnk_wide_core" + suffix, 4000, 2, 16, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, diffusion_guess, false, Settings::NONE, false, 200.0, 1.0e-7, 0,
+                true, 1 } );
+    }
+    cases.push_back( { "jfnk_reference", 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE, Settings::DIAMOND_DIFFERENCE,
+            0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, true, 1 } );
+    cases.push_back( { "jfnk_scattering", 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE, Settings::DIAMOND_DIFFERENCE,
+            0, true, true, Settings::NONE, false, 30.0, 1.0e-5, 0, true, 1 } );
+    for( unsigned int threads : { 1u, 2u, 4u } )
+    {
+        const std::string suffix = "_t" + std::to_string( threads );
+        cases.push_back( { "threads_reference" + suffix, 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, threads } );
+        cases.push_back( { "threads_many_groups_200" + suffix, 250, 200, 8, 8, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 0, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, threads } );
+        cases.push_back( { "threads_scattering_p5" + suffix, 6250, 2, 64, 1, Settings::FULL, Settings::DOUBLE,
+                Settings::DIAMOND_DIFFERENCE, 5, true, false, Settings::NONE, false, 30.0, 1.0e-5, 0, false, threads } );
+    }
+    return cases;
+}
+
+}
+
+int main( int argc, char *argv[] )
+{
+    // Benchmarks whose names contain any of the given arguments are run, all
+    // of them if no arguments are given. Results are written to standard
+    // output as JSON.
+    std::vector<BenchCase> selected;
+    for( const BenchCase &bench_case : BenchCases() )
+    {
+        bool match = argc < 2;
+        for( int i = 1; i < argc; i++ )
+        {
+            match = match || bench_case.name.find( argv[i] ) != std::string::npos;
+        }
+        if( match )
+        {
+            selected.push_back( bench_case );
+        }
+    }
+
+    int status = 0;
+    std::cout << "{\n  \"benchmarks\": [\n";
+    for( auto it = selected.begin(); it != selected.end(); it++ )
+    {
+        std::cout << "    ";
+        std::cout.flush();
+        // Each benchmark runs in its own process so that its peak resident
+        // set size is not inherited from the benchmarks before it
+        pid_t pid = fork();
+        if( pid == 0 )
+        {
+            RunCase( *it );
+            _exit( 0 );
+        }
+        int child_status = 1;
+        if( pid < 0 || waitpid( pid, &child_status, 0 ) < 0 || child_status != 0 )
+        {
+            std::cerr << "biscotti_bench: " << it->name << " failed" << std::endl;
+            std::cout << "{ \"name\": \"" << it->name << "\", \"failed\": true }";
+            status = 1;
+        }
+        std::cout << ( std::next( it ) == selected.end() ? "\n" : ",\n" );
+    }
+    std::cout << "  ]\n}" << std::endl;
+    return status;
+}
@@ -1,13 +1,8 @@
 #!/bin/bash
 
-PROJECT_DIR='/Users/atumulak/Developer/sn-solver'
+PROJECT_DIR='/Users/atumulak/Developer/biscotti'
 
 cd $PROJECT_DIR
 
-rm src/sn-solver.cpp
-cp $1 src/sn-solver.cpp
-
-make
-
-bin/sn-solver | tee -a $2
+bin/biscotti $1 | tee -a $2
 python scripts/process.py $2
@@ -0,0 +1,197 @@
+// adaptivemesh.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+// biscotti includes
+#include "adaptivemesh.hpp"
+#include "layout.hpp"
+#include "segment.hpp"
+
+// Start from the cells of a layout
+AdaptiveMesh::AdaptiveMesh( const Layout &layout ):
+    base_( layout )
+{
+    for( unsigned int s = 0; s != base_.NumSegments(); s++ )
+    {
+        for( int c = 0; c != base_.SegmentReference( s ).NumCells(); c++ )
+        {
+            cells_.push_back( { s, (unsigned int) c, 0, 0 } );
+        }
+    }
+}
+
+// Generate layout of the current mesh, one segment per run of equal cells
+Layout AdaptiveMesh::GenerateLayout() const
+{
+    Layout layout;
+    auto run_begin = cells_.begin();
+    while( run_begin != cells_.end() )
+    {
+        auto run_end = std::find_if( run_begin, cells_.end(),
+                [ run_begin ]( const MeshCell &cell )
+                {
+                    return cell.segment != run_begin->segment || cell.level != run_begin->level;
+                } );
+        const unsigned int num_cells = run_end - run_begin;
+        layout.AddToEnd( base_.SegmentReference( run_begin->segment ), num_cells * Width( *run_begin ), num_cells );
+        run_begin = run_end;
+    }
+    return layout;
+}
+
+// Return cell widths, left to right
+std::vector<double> AdaptiveMesh::CellWidths() const
+{
+    std::vector<double> widths;
+    widths.reserve( cells_.size() );
+    for( const MeshCell &cell : cells_ )
+    {
+        widths.push_back( Width( cell ) );
+    }
+    return widths;
+}
+
+// Return highest refinement level of any cell
+unsigned int AdaptiveMesh::MaxLevel() const
+{
+    unsigned int max_level = 0;
+    for( const MeshCell &cell : cells_ )
+    {
+        max_level = std::max( max_level, cell.level );
+    }
+    return max_level;
+}
+
+// Refine and coarsen given the scalar flux of each cell
+bool AdaptiveMesh::Adapt( const std::vector<double> &scl_flux, unsigned int num_groups, double tolerance,
+        unsigned int max_level )
+{
+    assert( scl_flux.size() == cells_.size() * num_groups );
+    const std::vector<double> indicators = ErrorIndicators( scl_flux, num_groups );
+    std::vector<MeshCell> adapted;
+    adapted.reserve( 2 * cells_.size() );
+    bool changed = false;
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        const MeshCell &cell = cells_[ i ];
+        if( indicators[ i ] > tolerance && cell.level < max_level )
+        {
+            adapted.push_back( { cell.segment, cell.base_cell, cell.level + 1, 2 * cell.offset } );
+            adapted.push_back( { cell.segment, cell.base_cell, cell.level + 1, 2 * cell.offset + 1 } );
+            changed = true;
+        }
+        else if( cell.level > 0 && cell.offset % 2 == 0 && i + 1 != cells_.size() &&
+                cells_[ i + 1 ].segment == cell.segment && cells_[ i + 1 ].base_cell == cell.base_cell &&
+                cells_[ i + 1 ].level == cell.level && indicators[ i ] < 0.125 * tolerance &&
+                indicators[ i + 1 ] < 0.125 * tolerance )
+        {
+            // Merge with the sibling to the right
+            adapted.push_back( { cell.segment, cell.base_cell, cell.level - 1, cell.offset / 2 } );
+            changed = true;
+            i++;
+        }
+        else
+        {
+            adapted.push_back( cell );
+        }
+    }
+    cells_.swap( adapted );
+    return changed;
+}
+
+// Project cell averages from one mesh onto another covering the same slab
+std::vector<double> AdaptiveMesh::Project( const std::vector<double> &values, unsigned int num_groups,
+        const std::vector<double> &from_widths, const std::vector<double> &to_widths )
+{
+    assert( values.size() == from_widths.size() * num_groups );
+    std::vector<double> projected( to_widths.size() * num_groups, 0.0 );
+    std::size_t from = 0;
+    double from_left = 0.0;
+    double to_left = 0.0;
+    for( std::size_t to = 0; to != to_widths.size(); to++ )
+    {
+        const double to_right = to_left + to_widths[ to ];
+        double covered = 0.0;
+        while( from != from_widths.size() )
+        {
+            const double from_right = from_left + from_widths[ from ];
+            const double overlap = std::min( from_right, to_right ) - std::max( from_left, to_left );
+            if( overlap > 0.0 )
+            {
+                for( unsigned int g = 0; g != num_groups; g++ )
+                {
+                    projected[ to * num_groups + g ] += overlap * values[ from * num_groups + g ];
+                }
+                covered += overlap;
+            }
+            // Move on to the next source cell only once it is used up
+            if( from_right > to_right )
+            {
+                break;
+            }
+            from_left = from_right;
+            from++;
+        }
+        for( unsigned int g = 0; g != num_groups && covered > 0.0; g++ )
+        {
+            projected[ to * num_groups + g ] /= covered;
+        }
+        to_left = to_right;
+    }
+    return projected;
+}
+
+// Return width of a mesh cell
+double AdaptiveMesh::Width( const MeshCell &cell ) const
+{
+    return base_.SegmentReference( cell.segment ).CellWidth() / double( 1u << cell.level );
+}
+
+// Return error indicator of each cell
+std::vector<double> AdaptiveMesh::ErrorIndicators( const std::vector<double> &scl_flux, unsigned int num_groups ) const
+{
+    const std::size_t num_cells = cells_.size();
+    std::vector<double> indicators( num_cells, 0.0 );
+    if( num_cells < 3 )
+    {
+        return indicators;
+    }
+    std::vector<double> centers( num_cells );
+    double left = 0.0;
+    for( std::size_t i = 0; i != num_cells; i++ )
+    {
+        const double width = Width( cells_[ i ] );
+        centers[ i ] = left + 0.5 * width;
+        left += width;
+    }
+    for( unsigned int g = 0; g != num_groups; g++ )
+    {
+        double max_flux = 0.0;
+        for( std::size_t i = 0; i != num_cells; i++ )
+        {
+            max_flux = std::max( max_flux, std::fabs( scl_flux[ i * num_groups + g ] ) );
+        }
+        if( max_flux == 0.0 )
+        {
+            continue;
+        }
+        for( std::size_t i = 0; i != num_cells; i++ )
+        {
+            // Boundary cells use the curvature of their interior neighbor
+            const std::size_t c = std::min( std::max( i, std::size_t( 1 ) ), num_cells - 2 );
+            const double left_slope = ( scl_flux[ c * num_groups + g ] - scl_flux[ ( c - 1 ) * num_groups + g ] ) /
+                ( centers[ c ] - centers[ c - 1 ] );
+            const double right_slope = ( scl_flux[ ( c + 1 ) * num_groups + g ] - scl_flux[ c * num_groups + g ] ) /
+                ( centers[ c + 1 ] - centers[ c ] );
+            const double curvature = 2.0 * ( right_slope - left_slope ) / ( centers[ c + 1 ] - centers[ c - 1 ] );
+            const double width = Width( cells_[ i ] );
+            indicators[ i ] = std::max( indicators[ i ], width * width * std::fabs( curvature ) / max_flux );
+        }
+    }
+    return indicators;
+}
@@ -0,0 +1,80 @@
+// adaptivemesh.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <vector>
+
+// biscotti includes
+#include "layout.hpp"
+
+// Nonuniform mesh built by repeatedly halving the cells of a layout. Each cell
+// of the mesh is a piece of one cell of the base layout, split level times.
+// Cells are refined where the scalar flux curvature is large and merged back
+// with their sibling where it is small, never below the base layout cells.
+class AdaptiveMesh
+{
+    public:
+
+        // Start from the cells of a layout. The layout must outlive the mesh.
+        AdaptiveMesh( const Layout &layout );
+
+        // Generate layout of the current mesh, one segment per run of equal
+        // cells
+        Layout GenerateLayout() const;
+
+        // Return cell widths, left to right
+        std::vector<double> CellWidths() const;
+
+        // Return number of cells
+        unsigned int NumCells() const { return cells_.size(); };
+
+        // Return highest refinement level of any cell
+        unsigned int MaxLevel() const;
+
+        // Refine and coarsen given the scalar flux of each cell (num_groups
+        // values per cell, left to right). Cells whose error indicator exceeds
+        // tolerance are halved unless at max_level, sibling pairs whose
+        // indicators are both below an eighth of tolerance are merged. Return
+        // true if the mesh changed.
+        bool Adapt( const std::vector<double> &scl_flux, unsigned int num_groups, double tolerance,
+                unsigned int max_level );
+
+        // Project cell averages of num_groups values per cell from a mesh with
+        // cell widths from_widths onto one with cell widths to_widths covering
+        // the same slab, weighting by overlap
+        static std::vector<double> Project( const std::vector<double> &values, unsigned int num_groups,
+                const std::vector<double> &from_widths, const std::vector<double> &to_widths );
+
+    private:
+
+        // A cell of the mesh
+        struct MeshCell
+        {
+            // Index of base segment
+            unsigned int segment;
+
+            // Index of base cell within the segment
+            unsigned int base_cell;
+
+            // Number of times the base cell has been halved
+            unsigned int level;
+
+            // Index of this piece within the base cell, 0 to 2^level - 1
+            unsigned int offset;
+        };
+
+        // Return width of a mesh cell
+        double Width( const MeshCell &cell ) const;
+
+        // Return error indicator of each cell: the largest over groups of
+        // h^2 |phi''| relative to the largest scalar flux of the group
+        std::vector<double> ErrorIndicators( const std::vector<double> &scl_flux, unsigned int num_groups ) const;
+
+        // Base layout
+        const Layout &base_;
+
+        // Cells left to right
+        std::vector<MeshCell> cells_;
+};
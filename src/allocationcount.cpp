@@ -0,0 +1,45 @@
+// allocationcount.cpp
+// Aaron G. Tumulak
+
+#ifdef BISCOTTI_COUNT_ALLOCATIONS
+
+// std includes
+#include <cstdlib>
+#include <new>
+
+// biscotti includes
+#include "allocationcount.hpp"
+
+namespace
+{
+
+// Allocations made by this thread
+thread_local unsigned long allocation_count = 0;
+
+}
+
+// Number of heap allocations made by the calling thread so far
+unsigned long AllocationCount()
+{
+    return allocation_count;
+}
+
+// Replacement global allocation functions. The default array forms call these.
+
+void *operator new( std::size_t size )
+{
+    allocation_count++;
+    void *p = std::malloc( size != 0 ? size : 1 );
+    if( p == nullptr )
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete( void *p ) noexcept
+{
+    std::free( p );
+}
+
+#endif
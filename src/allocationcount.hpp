@@ -0,0 +1,13 @@
+// allocationcount.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// Number of heap allocations made by the calling thread so far. Only counted
+// when built with BISCOTTI_COUNT_ALLOCATIONS, which replaces the global
+// operator new; otherwise always zero.
+#ifdef BISCOTTI_COUNT_ALLOCATIONS
+unsigned long AllocationCount();
+#else
+inline unsigned long AllocationCount() { return 0; }
+#endif
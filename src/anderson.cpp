@@ -0,0 +1,156 @@
+// anderson.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// biscotti includes
+#include "anderson.hpp"
+
+// Mix vectors of size values with a history of depth iterations
+Anderson::Anderson( std::size_t size, unsigned int depth ):
+    size_( size ),
+    depth_( depth ),
+    iterate_( size ),
+    prev_map_( size ),
+    prev_residual_( size ),
+    residual_( size ),
+    map_diffs_( depth, std::vector<double>( size ) ),
+    residual_diffs_( depth, std::vector<double>( size ) ),
+    normal_( depth * depth ),
+    coefficients_( depth )
+{
+    Reset();
+}
+
+// Forget all iterations
+void Anderson::Reset()
+{
+    history_size_ = 0;
+    newest_ = depth_ - 1;
+    started_ = false;
+    has_prev_ = false;
+}
+
+// Replace the map value of the last iterate with the next iterate
+bool Anderson::Mix( std::vector<double> &values )
+{
+    if( !started_ )
+    {
+        std::copy( values.begin(), values.end(), iterate_.begin() );
+        started_ = true;
+        return true;
+    }
+    for( std::size_t i = 0; i != size_; i++ )
+    {
+        residual_[ i ] = values[ i ] - iterate_[ i ];
+    }
+    if( has_prev_ && depth_ != 0 )
+    {
+        newest_ = ( newest_ + 1 ) % depth_;
+        std::vector<double> &map_diff = map_diffs_[ newest_ ];
+        std::vector<double> &residual_diff = residual_diffs_[ newest_ ];
+        for( std::size_t i = 0; i != size_; i++ )
+        {
+            map_diff[ i ] = values[ i ] - prev_map_[ i ];
+            residual_diff[ i ] = residual_[ i ] - prev_residual_[ i ];
+        }
+        history_size_ = std::min( history_size_ + 1, depth_ );
+    }
+    std::copy( values.begin(), values.end(), prev_map_.begin() );
+    std::copy( residual_.begin(), residual_.end(), prev_residual_.begin() );
+    has_prev_ = true;
+
+    // The mixed iterate is the map value less the combination of map value
+    // differences that best cancels the residual
+    bool nonnegative = true;
+    if( history_size_ != 0 && SolveCoefficients() )
+    {
+        for( std::size_t i = 0; i != size_ && nonnegative; i++ )
+        {
+            double value = values[ i ];
+            for( unsigned int j = 0; j != history_size_; j++ )
+            {
+                value -= coefficients_[ j ] * map_diffs_[ ( newest_ + depth_ - j ) % depth_ ][ i ];
+            }
+            iterate_[ i ] = value;
+            nonnegative = value >= 0.0;
+        }
+        if( nonnegative )
+        {
+            std::copy( iterate_.begin(), iterate_.end(), values.begin() );
+        }
+        else
+        {
+            history_size_ = 0;
+        }
+    }
+    std::copy( values.begin(), values.end(), iterate_.begin() );
+    return nonnegative;
+}
+
+// Solve the least squares problem for the mixing coefficients
+bool Anderson::SolveCoefficients()
+{
+    // Normal equations of minimizing | residual - sum_j c_j residual_diff_j |,
+    // newest difference first
+    const unsigned int m = history_size_;
+    for( unsigned int a = 0; a != m; a++ )
+    {
+        const std::vector<double> &diff_a = residual_diffs_[ ( newest_ + depth_ - a ) % depth_ ];
+        for( unsigned int b = 0; b <= a; b++ )
+        {
+            const std::vector<double> &diff_b = residual_diffs_[ ( newest_ + depth_ - b ) % depth_ ];
+            double sum = 0.0;
+            for( std::size_t i = 0; i != size_; i++ )
+            {
+                sum += diff_a[ i ] * diff_b[ i ];
+            }
+            normal_[ a * m + b ] = sum;
+            normal_[ b * m + a ] = sum;
+        }
+        double sum = 0.0;
+        for( std::size_t i = 0; i != size_; i++ )
+        {
+            sum += diff_a[ i ] * residual_[ i ];
+        }
+        coefficients_[ a ] = sum;
+    }
+
+    // Gaussian elimination of the symmetric positive semidefinite system. A
+    // pivot lost to round off means the differences are linearly dependent.
+    double scale = 0.0;
+    for( unsigned int a = 0; a != m; a++ )
+    {
+        scale = std::max( scale, normal_[ a * m + a ] );
+    }
+    for( unsigned int a = 0; a != m; a++ )
+    {
+        const double pivot = normal_[ a * m + a ];
+        if( !( pivot > 1.0e-12 * scale ) )
+        {
+            return false;
+        }
+        for( unsigned int b = a + 1; b != m; b++ )
+        {
+            const double factor = normal_[ b * m + a ] / pivot;
+            for( unsigned int c = a; c != m; c++ )
+            {
+                normal_[ b * m + c ] -= factor * normal_[ a * m + c ];
+            }
+            coefficients_[ b ] -= factor * coefficients_[ a ];
+        }
+    }
+    for( unsigned int a = m; a-- != 0; )
+    {
+        double value = coefficients_[ a ];
+        for( unsigned int b = a + 1; b != m; b++ )
+        {
+            value -= normal_[ a * m + b ] * coefficients_[ b ];
+        }
+        coefficients_[ a ] = value / normal_[ a * m + a ];
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+// anderson.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <cstddef>
+#include <vector>
+
+// Anderson mixing of a fixed point iteration x -> G(x) on nonnegative vectors.
+// Each new map value is combined with those of the last depth iterations so as
+// to minimize the least squares residual G(x) - x of the combination. The
+// differences of successive map values and residuals are kept in rings of
+// depth vectors, allocated up front so that mixing does not allocate.
+class Anderson
+{
+    public:
+
+        // Mix vectors of size values with a history of depth iterations
+        Anderson( std::size_t size, unsigned int depth );
+
+        // Forget all iterations, so that the next call to Mix() starts over
+        void Reset();
+
+        // Replace the map value G(x) of the last iterate x returned with the
+        // next iterate. The first call after a reset takes values as the
+        // first iterate and leaves them unchanged. Return false if the mixed
+        // iterate had a negative value, in which case values are left
+        // unchanged and the history is dropped.
+        bool Mix( std::vector<double> &values );
+
+        // Accessors and mutators //
+
+        // Return number of iterations whose differences are in the history
+        unsigned int HistorySize() const { return history_size_; };
+
+    private:
+
+        // Solve the least squares problem for the mixing coefficients of the
+        // history in coefficients_. Return false if it is singular.
+        bool SolveCoefficients();
+
+        // Number of values mixed
+        std::size_t size_;
+
+        // Number of iterations kept
+        unsigned int depth_;
+
+        // Number of iterations in the history
+        unsigned int history_size_;
+
+        // Ring index of the newest iteration in the history
+        unsigned int newest_;
+
+        // True once an iterate has been returned
+        bool started_;
+
+        // Last iterate returned
+        std::vector<double> iterate_;
+
+        // Map value and residual of the last iterate returned, if any was
+        // mixed before it
+        std::vector<double> prev_map_;
+        std::vector<double> prev_residual_;
+        bool has_prev_;
+
+        // Residual of the current map value
+        std::vector<double> residual_;
+
+        // Rings of map value and residual differences of successive iterations
+        std::vector<std::vector<double>> map_diffs_;
+        std::vector<std::vector<double>> residual_diffs_;
+
+        // Normal equations of the least squares problem, depth by depth, and
+        // the mixing coefficients
+        std::vector<double> normal_;
+        std::vector<double> coefficients_;
+};
@@ -3,124 +3,85 @@
 
 // std includes
 #include <algorithm>
-#include <cassert>
 #include <iostream>
-#include <map>
-#include <numeric>
 
 // biscotti includes
 #include "angledependent.hpp"
+#include "quadrature.hpp"
 
-// Default constructor
-AngleDependent::AngleDependent( double init_val )
+// View constructor
+template<typename T>
+AngleDependent<T>::AngleDependent( const Quadrature &quadrature, T *data ):
+    quadrature_( quadrature ),
+    data_( data )
+{}
+
+// Return scalar sum, accumulated in double
+template<typename T>
+double AngleDependent<T>::WeightedSum() const
 {
-    std::initializer_list<std::initializer_list<double>> il;
-    #include "quadrature.dsv"
-    for( auto it = il.begin(); it != il.end(); it++ )
+    double sum = 0.0;
+    for( unsigned int i = 0; i != quadrature_.Order(); i++ )
     {
-        assert( it->size() == 2 );
-        data_[ *std::next( it->begin() ) ] = std::make_pair( *it->begin() , init_val );
+        sum += quadrature_.Weights()[ i ] * data_[ i ];
     }
+    return sum;
 }
 
-// Return scalar sum
-double AngleDependent::WeightedSum() const
-{
-    return std::accumulate( data_.begin(), data_.end(), 0.0,
-            []( const double &x, const std::pair<double,std::pair<double,double>> &p )
-            {
-                return x + p.second.first * p.second.second;
-            } );
-}
-
-// Vacuum boundary (incoming on left side)
-void AngleDependent::LeftVacuumBoundary()
-{
-    std::for_each( pos_begin(), pos_end(),
-            []( std::pair<const double,std::pair<double,double>> &p )
-            {
-                p.second.second = 0.0;
-            } );
-}
-
-// [Adjoint] Vacuum boundary (outgoing on left side)
-void AngleDependent::AdjLeftVacuumBoundary()
-{
-    std::for_each( neg_begin(), neg_end(),
-            []( std::pair<const double,std::pair<double,double>> &p )
-            {
-                p.second.second = 0.0;
-            } );
-}
-
-// Reflect boundary (reflecting on left side, negative->positive)
-void AngleDependent::LeftReflectBoundary()
+// Vacuum boundary (zero the positive or negative ordinates)
+template<typename T>
+void AngleDependent<T>::ZeroOrdinates( bool positive )
 {
-    typedef std::map<double,std::pair<double,double>>::const_iterator const_angflux_it;
-    typedef std::map<double,std::pair<double,double>>::reverse_iterator reverse_angflux_it;
-    const_angflux_it neg_it = data_.begin(); // Negative iterator moving positive
-    reverse_angflux_it pos_it = data_.rbegin(); // Positive iterator moving negative
-    for( ; neg_it != std::next( data_.begin(), data_.size() / 2 ); neg_it++, pos_it++ )
+    if( positive )
     {
-        pos_it->second.second = neg_it->second.second;
+        std::fill( pos_begin(), pos_end(), T( 0 ) );
     }
-}
-
-// [Adjoint] Reflect boundary (reflecting on left side, positive->negative)
-void AngleDependent::AdjLeftReflectBoundary()
-{
-    typedef std::map<double,std::pair<double,double>>::iterator angflux_it;
-    typedef std::map<double,std::pair<double,double>>::const_reverse_iterator const_reverse_angflux_it;
-    angflux_it neg_it = data_.begin(); // Negative iterator moving positive
-    const_reverse_angflux_it pos_it = data_.rbegin(); // Positive iterator moving negative
-    for( ; neg_it != std::next( data_.begin(), data_.size() / 2 ); neg_it++, pos_it++ )
+    else
     {
-        neg_it->second.second = pos_it->second.second;
+        std::fill( neg_begin(), neg_end(), T( 0 ) );
     }
 }
 
-// Reflect boundary (reflecting on right side, positive->negative))
-void AngleDependent::RightReflectBoundary()
+// Reflect boundary (mirror the opposite ordinates into the positive or negative
+// ordinates). Ordinates are stored in ascending order, so the mirror image of
+// the i-th negative ordinate is the i-th positive ordinate from the end.
+template<typename T>
+void AngleDependent<T>::ReflectOrdinates( bool into_positive )
 {
-    typedef std::map<double,std::pair<double,double>>::iterator angflux_it;
-    typedef std::map<double,std::pair<double,double>>::const_reverse_iterator const_reverse_angflux_it;
-    angflux_it neg_it = data_.begin(); // Negative iterator moving positive
-    const_reverse_angflux_it pos_it = data_.rbegin(); // Positive iterator moving negative
-    for( ; neg_it != std::next( data_.begin(), data_.size() / 2 ); neg_it++, pos_it++ )
+    if( into_positive )
     {
-        neg_it->second.second = pos_it->second.second;
+        std::reverse_copy( neg_begin(), neg_end(), pos_begin() );
     }
-}
-
-// [Adjoint] Reflect boundary (reflecting on right side, negative->positive)
-void AngleDependent::AdjRightReflectBoundary()
-{
-    typedef std::map<double,std::pair<double,double>>::const_iterator const_angflux_it;
-    typedef std::map<double,std::pair<double,double>>::reverse_iterator reverse_angflux_it;
-    const_angflux_it neg_it = data_.begin(); // Negative iterator moving positive
-    reverse_angflux_it pos_it = data_.rbegin(); // Positive iterator moving negative
-    for( ; neg_it != std::next( data_.begin(), data_.size() / 2 ); neg_it++, pos_it++ )
+    else
     {
-        pos_it->second.second = neg_it->second.second;
+        std::reverse_copy( pos_begin(), pos_end(), neg_begin() );
     }
 }
 
 // Friend functions //
 
 // Overload operator<<()
-std::ostream &operator<< ( std::ostream &out, const AngleDependent &obj )
+template<typename T>
+std::ostream &operator<< ( std::ostream &out, const AngleDependent<T> &obj )
 {
-    for( auto it = obj.data_.begin(); it != obj.data_.end(); it++ )
+    for( unsigned int i = 0; i != obj.quadrature_.Order(); i++ )
     {
-        out << it->second.second;
-        if( it != prev( obj.data_.end() ) )
+        out << obj.data_[ i ];
+        if( i + 1 != obj.quadrature_.Order() )
         {
-            std::cout << ",";
+            out << ",";
         }
         else
         {
-            std::cout << std::endl;
+            out << std::endl;
         }
     }
     return out;
 }
+
+// Explicit instantiations //
+
+template class AngleDependent<double>;
+template class AngleDependent<float>;
+template std::ostream &operator<< ( std::ostream &out, const AngleDependent<double> &obj );
+template std::ostream &operator<< ( std::ostream &out, const AngleDependent<float> &obj );
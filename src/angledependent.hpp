@@ -5,64 +5,62 @@
 
 // std includes
 #include <iostream>
-#include <map>
 
+// biscotti includes
+#include "quadrature.hpp"
+
+// View of the angular flux of a single energy group. Values are owned by an
+// AngularFlux and stored contiguously as T in the ordinate order of the
+// quadrature (negative ordinates first).
+template<typename T>
 class AngleDependent
 {
     public:
 
-        // Default constructor
-        AngleDependent( double init_val );
+        // View constructor
+        AngleDependent( const Quadrature &quadrature, T *data );
 
-        // Return scalar sum
+        // Return scalar sum, accumulated in double
         double WeightedSum() const;
 
-        // Vacuum boundary (incoming on left side)
-        void LeftVacuumBoundary();
-
-        // [Adjoint] Vacuum boundary (outgoing on left side)
-        void AdjLeftVacuumBoundary();
-
-        // Reflect boundary (reflecting on left side, negative->positive)
-        void LeftReflectBoundary();
+        // Vacuum boundary (zero the positive or negative ordinates)
+        void ZeroOrdinates( bool positive );
 
-        // [Adjoint] Reflect boundary (reflecting on left side, positive->negative)
-        void AdjLeftReflectBoundary();
-
-        // Reflect boundary (reflecting on right side, positive->negative)
-        void RightReflectBoundary();
-
-        // [Adjoint] Reflect boundary (reflecting on right side, negative->positive)
-        void AdjRightReflectBoundary();
+        // Reflect boundary (mirror the opposite ordinates into the positive or
+        // negative ordinates)
+        void ReflectOrdinates( bool into_positive );
 
         // Iterators //
 
         // Iterators to positive and negative angles
-        typedef std::map<double,std::pair<double,double>>::iterator map_pair_it;
-        map_pair_it pos_begin() { return std::prev( data_.end(), data_.size() / 2 ); };
-        map_pair_it pos_end() { return data_.end(); };
-        map_pair_it neg_begin() { return data_.begin(); };
-        map_pair_it neg_end() { return std::next( data_.begin(), data_.size() / 2 ); };
+        T *pos_begin() { return data_ + quadrature_.Order() / 2; };
+        T *pos_end() { return data_ + quadrature_.Order(); };
+        T *neg_begin() { return data_; };
+        T *neg_end() { return data_ + quadrature_.Order() / 2; };
 
         // Const iterators to positive and negative angles
-        typedef std::map<double,std::pair<double,double>>::const_iterator const_map_pair_it;
-        const_map_pair_it pos_begin() const { return std::prev( data_.end(), data_.size() / 2 ); };
-        const_map_pair_it pos_end() const { return data_.end(); };
-        const_map_pair_it neg_begin() const { return data_.begin(); };
-        const_map_pair_it neg_end() const { return std::next( data_.begin(), data_.size() / 2 ); };
+        const T *pos_begin() const { return data_ + quadrature_.Order() / 2; };
+        const T *pos_end() const { return data_ + quadrature_.Order(); };
+        const T *neg_begin() const { return data_; };
+        const T *neg_end() const { return data_ + quadrature_.Order() / 2; };
 
         // Friend functions //
 
         // Overload operator<<()
-        friend std::ostream &operator<< ( std::ostream &out, const AngleDependent &obj );
+        template<typename U>
+        friend std::ostream &operator<< ( std::ostream &out, const AngleDependent<U> &obj );
 
     private:
 
+        // Quadrature the values are defined on
+        const Quadrature &quadrature_;
+
         // Angular flux data
-        std::map<double,std::pair<double,double>> data_;
+        T *data_;
 };
 
 // Friend functions //
 
 // Overload operator<<()
-std::ostream &operator<< ( std::ostream &out, const AngleDependent &obj );
+template<typename T>
+std::ostream &operator<< ( std::ostream &out, const AngleDependent<T> &obj );
@@ -3,127 +3,306 @@
 
 // std includes
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <vector>
 
 // biscotti includes
 #include "angledependent.hpp"
 #include "angularflux.hpp"
 #include "groupdependent.hpp"
+#include "quadrature.hpp"
+#include "settings.hpp"
+
+namespace
+{
+
+// Write sum over the positive or negative ordinates of each group of values
+// stored as T, weighted by one value per ordinate, to sums, accumulated in
+// double
+template<typename T>
+void HalfWeightedSums( const Quadrature &quadrature, const double *ordinate_weights, unsigned int num_groups,
+        const T *data, bool positive, double *sums )
+{
+    const unsigned int order = quadrature.Order();
+    const unsigned int offset = positive ? order / 2 : 0;
+    const double *weights = ordinate_weights + offset;
+    for( unsigned int g = 0; g != num_groups; g++ )
+    {
+        const T *values = data + g * order + offset;
+        double sum = 0.0;
+        for( unsigned int a = 0; a != order / 2; a++ )
+        {
+            sum += weights[ a ] * values[ a ];
+        }
+        sums[ g ] = sum;
+    }
+}
+
+}
 
 // Default constructor
-AngularFlux::AngularFlux( GroupDependent init_energies, double init_scl_flux ):
+AngularFlux::AngularFlux( const std::vector<double> &energies, const Quadrature &quadrature, double init_scl_flux,
+        Settings::Precision precision ):
+    energies_( &energies ),
+    quadrature_( &quadrature ),
+    precision_( precision ),
+    data_( precision == Settings::DOUBLE ? energies.size() * quadrature.Order() : 0, 0.5 * init_scl_flux ),
+    float_data_( precision == Settings::FLOAT ? energies.size() * quadrature.Order() : 0, float( 0.5 * init_scl_flux ) ),
+    scl_flux_( energies.size() ),
     scl_flux_updated_( false )
+{}
+
+// Vacuum boundary (zero the positive or negative ordinates)
+void AngularFlux::ZeroOrdinates( bool positive )
 {
-    // Fill angular fluxes
-    for( auto energy_it = init_energies.slowest(); energy_it != std::next( init_energies.fastest() ); energy_it++ )
+    for( unsigned int g = 0; g != NumGroups(); g++ )
     {
-        data_.insert( std::make_pair( energy_it->first, AngleDependent( 0.5 * init_scl_flux ) ) );
+        if( precision_ == Settings::FLOAT )
+        {
+            Group( float_data_, g ).ZeroOrdinates( positive );
+        }
+        else
+        {
+            Group( data_, g ).ZeroOrdinates( positive );
+        }
     }
+    scl_flux_updated_ = false;
 }
 
-// Vacuum boundary (incoming on left side)
-void AngularFlux::LeftVacuumBoundary()
+// Reflect boundary (mirror the opposite ordinates into the positive or negative
+// ordinates)
+void AngularFlux::ReflectOrdinates( bool into_positive )
 {
-    std::for_each( data_.begin(), data_.end(),
-            []( std::pair<const double,AngleDependent> &p )
-            {
-                p.second.LeftVacuumBoundary();
-            } );
+    for( unsigned int g = 0; g != NumGroups(); g++ )
+    {
+        if( precision_ == Settings::FLOAT )
+        {
+            Group( float_data_, g ).ReflectOrdinates( into_positive );
+        }
+        else
+        {
+            Group( data_, g ).ReflectOrdinates( into_positive );
+        }
+    }
     scl_flux_updated_ = false;
 }
 
-// [Adjoint] Vacuum boundary (outgoing on left side)
-void AngularFlux::AdjLeftVacuumBoundary()
+// Weight all values by another angular flux of the same precision
+void AngularFlux::WeightBy( const AngularFlux &weight )
 {
-    std::for_each( data_.begin(), data_.end(),
-            []( std::pair<const double,AngleDependent> &p )
-            {
-                p.second.AdjLeftVacuumBoundary();
-            } );
+    assert( weight.precision_ == precision_ );
+    assert( weight.data_.size() == data_.size() && weight.float_data_.size() == float_data_.size() );
+    std::transform( data_.begin(), data_.end(), weight.data_.begin(), data_.begin(), std::multiplies<double>() );
+    std::transform( float_data_.begin(), float_data_.end(), weight.float_data_.begin(), float_data_.begin(),
+            std::multiplies<float>() );
     scl_flux_updated_ = false;
 }
 
-// Reflect boundary (reflecting on left side, negative->positive)
-void AngularFlux::LeftReflectBoundary()
+// Overwrite values with those of another angular flux on the same groups,
+// quadrature and precision (no allocation)
+void AngularFlux::CopyValues( const AngularFlux &other )
 {
-    std::for_each( data_.begin(), data_.end(),
-            []( std::pair<const double,AngleDependent> &p )
-            {
-                p.second.LeftReflectBoundary();
-            } );
+    assert( other.precision_ == precision_ );
+    assert( other.data_.size() == data_.size() && other.float_data_.size() == float_data_.size() );
+    std::copy( other.data_.begin(), other.data_.end(), data_.begin() );
+    std::copy( other.float_data_.begin(), other.float_data_.end(), float_data_.begin() );
     scl_flux_updated_ = false;
 }
 
-// [Adjoint] Reflect boundary (reflecting on left side, positive->negative)
-void AngularFlux::AdjLeftReflectBoundary()
+// Set every ordinate of each group to the isotropic flux of the given scalar
+// flux, slowest group first
+void AngularFlux::SetIsotropic( const double *scl_flux )
 {
-    std::for_each( data_.begin(), data_.end(),
-            []( std::pair<const double,AngleDependent> &p )
-            {
-                p.second.AdjLeftReflectBoundary();
-            } );
+    // The quadrature weights sum to 2
+    const unsigned int order = quadrature_->Order();
+    for( unsigned int g = 0; g != NumGroups(); g++ )
+    {
+        if( precision_ == Settings::FLOAT )
+        {
+            std::fill_n( float_data_.begin() + g * order, order, float( 0.5 * scl_flux[ g ] ) );
+        }
+        else
+        {
+            std::fill_n( data_.begin() + g * order, order, 0.5 * scl_flux[ g ] );
+        }
+    }
     scl_flux_updated_ = false;
 }
 
-// Reflect boundary (reflecting on right side, positive->negative)
-void AngularFlux::RightReflectBoundary()
+// Add the isotropic flux of the given scalar flux to every ordinate of each
+// group
+void AngularFlux::AddIsotropic( const double *scl_flux )
 {
-    std::for_each( data_.begin(), data_.end(),
-            []( std::pair<const double,AngleDependent> &p )
+    const unsigned int order = quadrature_->Order();
+    for( unsigned int g = 0; g != NumGroups(); g++ )
+    {
+        const double value = 0.5 * scl_flux[ g ];
+        for( unsigned int a = 0; a != order; a++ )
+        {
+            if( precision_ == Settings::FLOAT )
             {
-                p.second.RightReflectBoundary();
-            } );
-    scl_flux_updated_ = false;
+                float_data_[ g * order + a ] += float( value );
+            }
+            else
+            {
+                data_[ g * order + a ] += value;
+            }
+        }
+        // The quadrature weights sum to 2, so an up to date scalar flux stays
+        // up to date
+        scl_flux_[ g ] += scl_flux[ g ];
+    }
 }
 
-// [Adjoint] Reflect boundary (reflecting on right side, negative->positive)
-void AngularFlux::AdjRightReflectBoundary()
+// Write all values to values in double
+void AngularFlux::Values( double *values ) const
 {
-    std::for_each( data_.begin(), data_.end(),
-            []( std::pair<const double,AngleDependent> &p )
-            {
-                p.second.AdjRightReflectBoundary();
-            } );
+    if( precision_ == Settings::FLOAT )
+    {
+        std::copy( float_data_.begin(), float_data_.end(), values );
+    }
+    else
+    {
+        std::copy( data_.begin(), data_.end(), values );
+    }
+}
+
+// Overwrite all values with values in double
+void AngularFlux::SetValues( const double *values )
+{
+    if( precision_ == Settings::FLOAT )
+    {
+        std::copy( values, values + float_data_.size(), float_data_.begin() );
+    }
+    else
+    {
+        std::copy( values, values + data_.size(), data_.begin() );
+    }
     scl_flux_updated_ = false;
 }
 
-// Weight all values by another angular flux
-void AngularFlux::WeightBy( const AngularFlux &weight )
+// Write scalar flux of the positive or negative ordinates of each group to
+// values, slowest group first
+void AngularFlux::HalfScalarFlux( bool positive, double *values ) const
 {
-    std::map<double, AngleDependent>::iterator flux_energy_it = slowest();
-    std::map<double, AngleDependent>::const_iterator weight_energy_it = weight.slowest();
-    for( ; flux_energy_it != std::next( fastest() ); flux_energy_it++, weight_energy_it++ )
+    if( precision_ == Settings::FLOAT )
     {
-        std::map<double,std::pair<double,double>>::iterator flux_angle_it = flux_energy_it->second.neg_begin();
-        std::map<double,std::pair<double,double>>::const_iterator weight_angle_it = weight_energy_it->second.neg_begin();
-        for( ; flux_angle_it != flux_energy_it->second.pos_end(); flux_angle_it++, weight_angle_it++ )
+        HalfWeightedSums( *quadrature_, quadrature_->Weights().data(), NumGroups(), float_data_.data(), positive, values );
+    }
+    else
+    {
+        HalfWeightedSums( *quadrature_, quadrature_->Weights().data(), NumGroups(), data_.data(), positive, values );
+    }
+}
+
+// Write Legendre moments 1 through num_moments of the positive or negative
+// ordinates of each group to values, one block of groups per moment
+void AngularFlux::HalfMoments( bool positive, unsigned int num_moments, double *values ) const
+{
+    const unsigned int order = quadrature_->Order();
+    for( unsigned int l = 0; l != num_moments; l++ )
+    {
+        const double *row = quadrature_->DiscreteToMoment().data() + l * order;
+        if( precision_ == Settings::FLOAT )
+        {
+            HalfWeightedSums( *quadrature_, row, NumGroups(), float_data_.data(), positive, values + l * NumGroups() );
+        }
+        else
         {
-            flux_angle_it->second.second *= weight_angle_it->second.second;
+            HalfWeightedSums( *quadrature_, row, NumGroups(), data_.data(), positive, values + l * NumGroups() );
         }
     }
-    scl_flux_updated_ = false;
+}
+
+// Return memory used (bytes)
+std::size_t AngularFlux::MemoryUsage() const
+{
+    return sizeof( AngularFlux ) + sizeof( double ) * ( data_.capacity() + scl_flux_.capacity() ) +
+        sizeof( float ) * float_data_.capacity();
+}
+
+// Print values of group at energy, in reverse ordinate order if mirrored
+void AngularFlux::PrintGroup( std::ostream &out, double energy, bool mirrored ) const
+{
+    if( mirrored )
+    {
+        // A mirror image travels along the opposite ordinate
+        const unsigned int order = quadrature_->Order();
+        const std::size_t offset = GroupIndex( energy ) * order;
+        for( unsigned int i = 0; i != order; i++ )
+        {
+            const std::size_t index = offset + order - 1 - i;
+            if( precision_ == Settings::FLOAT )
+            {
+                out << float_data_[ index ];
+            }
+            else
+            {
+                out << data_[ index ];
+            }
+            i + 1 != order ? out << "," : out << std::endl;
+        }
+    }
+    else if( precision_ == Settings::FLOAT )
+    {
+        out << Group( float_data_, GroupIndex( energy ) );
+    }
+    else
+    {
+        out << Group( data_, GroupIndex( energy ) );
+    }
+}
+
+// Return scalar flux (allocates, prefer ScalarFluxValues())
+GroupDependent AngularFlux::ScalarFlux()
+{
+    const std::vector<double> &values = ScalarFluxValues();
+    GroupDependent scl_flux;
+    for( unsigned int g = 0; g != NumGroups(); g++ )
+    {
+        scl_flux.Set( ( *energies_ )[ g ], values[ g ] );
+    }
+    return scl_flux;
+}
+
+// Return scalar flux at energy, zero if the flux has no group at energy
+double AngularFlux::ScalarFluxAt( double energy )
+{
+    auto energy_it = std::find( energies_->begin(), energies_->end(), energy );
+    return energy_it != energies_->end() ? ScalarFluxValues()[ energy_it - energies_->begin() ] : 0.0;
 }
 
 // Update scalar flux
 void AngularFlux::UpdateScalarFlux()
 {
-    std::for_each( data_.begin(), data_.end(),
-            [this]( std::pair<const double,AngleDependent> &p )
-            {
-                scl_flux_.Set( p.first, p.second.WeightedSum() );
-            } );
+    for( unsigned int g = 0; g != NumGroups(); g++ )
+    {
+        scl_flux_[ g ] = precision_ == Settings::FLOAT ? Group( float_data_, g ).WeightedSum() : Group( data_, g ).WeightedSum();
+    }
     scl_flux_updated_ = true;
 }
 
+// Return index of group at energy
+unsigned int AngularFlux::GroupIndex( double energy ) const
+{
+    auto energy_it = std::find( energies_->begin(), energies_->end(), energy );
+    assert( energy_it != energies_->end() );
+    return energy_it - energies_->begin();
+}
+
 // Friend functions //
 
 // Overload operator<<()
 std::ostream &operator<< ( std::ostream &out, const AngularFlux &obj )
 {
-    for( auto it = obj.data_.begin(); it != obj.data_.end(); it++ )
+    for( unsigned int g = 0; g != obj.NumGroups(); g++ )
     {
-        out << "Energy group: " << it->first << std::endl;
-        out << it->second << std::endl;
+        out << "Energy group: " << ( *obj.energies_ )[ g ] << std::endl;
+        obj.PrintGroup( out, ( *obj.energies_ )[ g ] );
+        out << std::endl;
     }
     return out;
 }
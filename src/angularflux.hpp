@@ -4,47 +4,85 @@
 #pragma once
 
 // std includes
+#include <cassert>
+#include <cstddef>
 #include <iostream>
+#include <vector>
 
 // biscotti includes
 #include "angledependent.hpp"
 #include "groupdependent.hpp"
+#include "quadrature.hpp"
+#include "settings.hpp"
 
+// Group and angle dependent flux. Values are stored contiguously, one block of
+// ordinates per energy group, slowest group first, in double or single
+// precision. Scalar fluxes are always accumulated in double. The energy groups
+// are not owned and must outlive the flux.
 class AngularFlux
 {
     public:
 
         // Default constructor
-        AngularFlux( GroupDependent init_energies, double init_scl_flux );
+        AngularFlux( const std::vector<double> &energies, const Quadrature &quadrature, double init_scl_flux,
+                Settings::Precision precision = Settings::DOUBLE );
 
-        // Vacuum boundary (incoming on left side)
-        void LeftVacuumBoundary();
+        // Vacuum boundary (zero the positive or negative ordinates)
+        void ZeroOrdinates( bool positive );
 
-        // [Adjoint] Vacuum boundary (outgoing on left side)
-        void AdjLeftVacuumBoundary();
+        // Reflect boundary (mirror the opposite ordinates into the positive or
+        // negative ordinates)
+        void ReflectOrdinates( bool into_positive );
 
-        // Reflect boundary (reflecting on left side, negative->positive)
-        void LeftReflectBoundary();
+        // Weight all values by another angular flux of the same precision
+        void WeightBy( const AngularFlux &weight );
 
-        // [Adjoint] Reflect boundary (reflecting on left side, positive->negative)
-        void AdjLeftReflectBoundary();
+        // Overwrite values with those of another angular flux on the same
+        // groups, quadrature and precision (no allocation)
+        void CopyValues( const AngularFlux &other );
 
-        // Reflect boundary (reflecting on right side, positive->negative)
-        void RightReflectBoundary();
+        // Set every ordinate of each group to the isotropic flux of the given
+        // scalar flux, slowest group first
+        void SetIsotropic( const double *scl_flux );
 
-        // [Adjoint] Reflect boundary (reflecting on right side, negative->positive)
-        void AdjRightReflectBoundary();
+        // Add the isotropic flux of the given scalar flux to every ordinate of
+        // each group, slowest group first
+        void AddIsotropic( const double *scl_flux );
 
-        // Weight all values by another angular flux
-        void WeightBy( const AngularFlux &weight );
+        // Write all values to values in double, one block of ordinates per
+        // group, slowest group first
+        void Values( double *values ) const;
+
+        // Overwrite all values with values in double, one block of ordinates
+        // per group, slowest group first
+        void SetValues( const double *values );
+
+        // Write scalar flux of the positive or negative ordinates of each group
+        // to values, slowest group first
+        void HalfScalarFlux( bool positive, double *values ) const;
+
+        // Write Legendre moments 1 through num_moments of the positive or
+        // negative ordinates of each group to values, one block of groups per
+        // moment, slowest group first
+        void HalfMoments( bool positive, unsigned int num_moments, double *values ) const;
+
+        // Return memory used (bytes)
+        std::size_t MemoryUsage() const;
+
+        // Print values of group at energy, in reverse ordinate order if
+        // mirrored
+        void PrintGroup( std::ostream &out, double energy, bool mirrored = false ) const;
 
         // Accessors and mutators //
 
-        // Return const reference to AngleDependent value at energy
-        const AngleDependent &at( double energy ) const { return data_.at( energy ); };
+        // Return scalar flux (allocates, prefer ScalarFluxValues())
+        GroupDependent ScalarFlux();
+
+        // Return scalar flux at energy, zero if the flux has no group at energy
+        double ScalarFluxAt( double energy );
 
-        // Return const reference to scalar flux
-        const GroupDependent &ScalarFluxReference()
+        // Return const reference to scalar flux values, slowest group first
+        const std::vector<double> &ScalarFluxValues()
         {
             if( !scl_flux_updated_ )
             {
@@ -53,15 +91,34 @@ class AngularFlux
             return scl_flux_;
         };
 
-        // Iterators //
+        // Number of energy groups
+        unsigned int NumGroups() const { return energies_->size(); };
+
+        // Number of values, ordinates times groups
+        std::size_t Size() const { return energies_->size() * quadrature_->Order(); };
+
+        // Const reference to energy groups, slowest first
+        const std::vector<double> &Energies() const { return *energies_; };
+
+        // Const reference to quadrature
+        const Quadrature &QuadratureReference() const { return *quadrature_; };
 
-        // Iterators to fastest and slowest group
-        std::map<double,AngleDependent>::iterator slowest() { scl_flux_updated_ = false; return data_.begin(); };
-        std::map<double,AngleDependent>::iterator fastest() { scl_flux_updated_ = false; return std::prev( data_.end() ); };
+        // Precision values are stored in
+        Settings::Precision Precision() const { return precision_; };
 
-        // Const iterators to fastest and slowest group
-        std::map<double,AngleDependent>::const_iterator slowest() const { return data_.begin(); };
-        std::map<double,AngleDependent>::const_iterator fastest() const { return std::prev( data_.end() ); };
+        // Pointer to contiguous double precision values (marks scalar flux as
+        // outdated)
+        double *Data() { assert( precision_ == Settings::DOUBLE ); scl_flux_updated_ = false; return data_.data(); };
+
+        // Const pointer to contiguous double precision values
+        const double *Data() const { assert( precision_ == Settings::DOUBLE ); return data_.data(); };
+
+        // Pointer to contiguous single precision values (marks scalar flux as
+        // outdated)
+        float *FloatData() { assert( precision_ == Settings::FLOAT ); scl_flux_updated_ = false; return float_data_.data(); };
+
+        // Const pointer to contiguous single precision values
+        const float *FloatData() const { assert( precision_ == Settings::FLOAT ); return float_data_.data(); };
 
         // Friend functions //
 
@@ -73,11 +130,35 @@ class AngularFlux
         // Update scalar flux
         void UpdateScalarFlux();
 
-        // Underlying data structure for angular flux
-        std::map<double,AngleDependent> data_;
+        // Return index of group at energy
+        unsigned int GroupIndex( double energy ) const;
+
+        // Return view of group at index of values stored as T
+        template<typename T>
+        AngleDependent<T> Group( const std::vector<T> &data, unsigned int index ) const
+        {
+            return AngleDependent<T>( *quadrature_, const_cast<T *>( &data[ index * quadrature_->Order() ] ) );
+        };
+
+        // Energy groups, slowest first
+        const std::vector<double> *energies_;
+
+        // Quadrature the values are defined on
+        const Quadrature *quadrature_;
+
+        // Precision values are stored in
+        Settings::Precision precision_;
+
+        // Underlying data structure for angular flux in double precision, empty
+        // if stored in single precision
+        std::vector<double> data_;
+
+        // Underlying data structure for angular flux in single precision, empty
+        // if stored in double precision
+        std::vector<float> float_data_;
 
-        // Scalar flux
-        GroupDependent scl_flux_;
+        // Scalar flux values, slowest group first
+        std::vector<double> scl_flux_;
 
         // Scalar flux is updated
         bool scl_flux_updated_;
@@ -0,0 +1,33 @@
+// blocksum.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <cstddef>
+#include <vector>
+
+// biscotti includes
+#include "blocksum.hpp"
+
+const std::size_t BlockSum::BLOCK_SIZE;
+
+// Sum values of size indices
+BlockSum::BlockSum( std::size_t size ):
+    size_( size ),
+    block_sums_( ( size + BLOCK_SIZE - 1 ) / BLOCK_SIZE )
+{}
+
+// Add the block sums pairwise and return the total
+double BlockSum::AddBlocks()
+{
+    // Each pass adds the partial sum stride blocks on into every partial sum
+    // at a multiple of twice stride, leaving the total in the first block
+    const std::size_t num_blocks = block_sums_.size();
+    for( std::size_t stride = 1; stride < num_blocks; stride *= 2 )
+    {
+        for( std::size_t block = 0; block + stride < num_blocks; block += 2 * stride )
+        {
+            block_sums_[ block ] += block_sums_[ block + stride ];
+        }
+    }
+    return num_blocks != 0 ? block_sums_.front() : 0.0;
+}
@@ -0,0 +1,70 @@
+// blocksum.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// biscotti includes
+#include "threadpool.hpp"
+
+// Sum of one value per index whose rounding does not depend on the number of
+// threads. The indices are cut into fixed blocks of BLOCK_SIZE, each summed in
+// order by one thread, and the block sums are then added pairwise in a tree
+// fixed by the number of blocks. The block sums are allocated up front so that
+// summing does not allocate.
+class BlockSum
+{
+    public:
+
+        // Number of consecutive indices summed in order
+        static const std::size_t BLOCK_SIZE = 64;
+
+        // Sum values of size indices
+        explicit BlockSum( std::size_t size );
+
+        // Return the sum of value( i ) over all indices, with the blocks split
+        // over the threads of pool
+        template<class Value>
+        double Sum( ThreadPool &pool, const Value &value );
+
+        // Accessors and mutators //
+
+        // Return number of blocks
+        std::size_t NumBlocks() const { return block_sums_.size(); };
+
+    private:
+
+        // Add the block sums pairwise and return the total
+        double AddBlocks();
+
+        // Number of indices
+        std::size_t size_;
+
+        // Sum of each block, overwritten by partial sums of the tree
+        std::vector<double> block_sums_;
+};
+
+// Return the sum of value( i ) over all indices
+template<class Value>
+double BlockSum::Sum( ThreadPool &pool, const Value &value )
+{
+    pool.ParallelFor( block_sums_.size(),
+            [this, &value]( unsigned int, std::size_t begin, std::size_t end )
+            {
+                for( std::size_t block = begin; block != end; block++ )
+                {
+                    const std::size_t last = std::min( size_, ( block + 1 ) * BLOCK_SIZE );
+                    double sum = 0.0;
+                    for( std::size_t i = block * BLOCK_SIZE; i != last; i++ )
+                    {
+                        sum += value( i );
+                    }
+                    block_sums_[ block ] = sum;
+                }
+            } );
+    return AddBlocks();
+}
@@ -4,288 +4,679 @@
 // std includes
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
+#include <memory>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 // biscotti includes
 #include "angularflux.hpp"
 #include "cell.hpp"
+#include "flatmaterial.hpp"
+#include "scatteringkernel.hpp"
+#include "sweepkernel.hpp"
 
 // Default constructor
-Cell::Cell( const Settings &settings, const Segment &segment, const double &k, const double &adj_k ):
-    settings_( settings ),
+Cell::Cell( const Segment &segment, const Quadrature &quadrature, const Settings &settings,
+        std::shared_ptr<const std::vector<double>> characteristic ):
     segment_( segment ),
-    material_( segment_.MaterialReference() ),
-    k_( k ),
-    adj_k_( adj_k ),
-    mid_ext_src_( material_.ExtSource() ),
-    adj_mid_ext_src_( material_.AdjExtSource() ),
-    mid_angflux_( AngularFlux( material_.TotMacroXsec(), segment_.ScalarFluxGuess() ) ),
-    adj_mid_angflux_( AngularFlux( material_.TotMacroXsec(), segment_.AdjScalarFluxGuess() ) ),
-    out_angflux_( AngularFlux( material_.TotMacroXsec(), segment_.ScalarFluxGuess() ) ),
-    adj_out_angflux_( AngularFlux( material_.TotMacroXsec(), segment_.AdjScalarFluxGuess() ) ),
-    prev_mid_sclflux_( mid_angflux_.ScalarFluxReference() * 10.0 ),
-    adj_prev_mid_sclflux_( adj_mid_angflux_.ScalarFluxReference() * 10.0 )
+    quadrature_( quadrature ),
+    edge_( settings.AngularFluxStorage() == Settings::EDGE ),
+    precision_( settings.AngularFluxPrecision() ),
+    linear_( settings.SpatialScheme() == Settings::LINEAR_DISCONTINUOUS ),
+    scat_order_( settings.ScatteringOrder() ),
+    characteristic_( std::move( characteristic ) ),
+    forward_( segment_.FlatMaterialReference().Energies(), quadrature, segment_.FlatMaterialReference().ExtSource(),
+            segment_.ScalarFluxGuess(), edge_, precision_, linear_, scat_order_ ),
+    adjoint_( segment_.FlatMaterialReference().Energies(), quadrature, segment_.FlatMaterialReference().AdjExtSource(),
+            segment_.AdjScalarFluxGuess(), edge_, precision_, linear_, scat_order_ )
 {}
 
-// Sweep right
-void Cell::SweepRight( const AngularFlux &in_angflux )
-{
-    prev_mid_sclflux_ = mid_angflux_.ScalarFluxReference();
-    // Set up energy iterators
-    std::map<double,double>::const_iterator ext_src_it = mid_ext_src_.slowest();
-    std::map<double,double>::const_iterator fiss_src_it = mid_fiss_src_.slowest();
-    std::map<double,double>::const_iterator scat_src_it = mid_scat_src_.slowest();
-    std::map<double,double>::const_iterator abs_it = material_.TotMacroXsec().slowest();
-    std::map<double,AngleDependent>::const_iterator in_energy_it = in_angflux.slowest();
-    std::map<double,AngleDependent>::iterator mid_energy_it = mid_angflux_.slowest();
-    std::map<double,AngleDependent>::iterator out_energy_it = out_angflux_.slowest();
-    // Loop through each energy
-    for( ;
-            in_energy_it != std::next( in_angflux.fastest() );
-            ext_src_it++,
-            fiss_src_it++,
-            scat_src_it++,
-            abs_it++,
-            in_energy_it++,
-            mid_energy_it++,
-            out_energy_it++ )
-    {
-        // Set up angle iterators
-        std::map<double,std::pair<double,double>>::const_iterator in_angle_it = in_energy_it->second.pos_begin();
-        std::map<double,std::pair<double,double>>::iterator mid_angle_it = mid_energy_it->second.pos_begin();
-        std::map<double,std::pair<double,double>>::iterator out_angle_it = out_energy_it->second.pos_begin();
-        // Loop through each angle
-        for( ; in_angle_it != in_energy_it->second.pos_end(); in_angle_it++, mid_angle_it++, out_angle_it++ )
+// Transport state constructor
+Cell::State::State( const std::vector<double> &energies, const Quadrature &quadrature, const std::vector<double> &ext_src,
+        double scl_flux_guess, bool edge, Settings::Precision precision, bool linear, unsigned int scat_order ):
+    ext_src( ext_src ),
+    scat_src( energies.size() ),
+    fiss_src( energies.size() ),
+    sweep_src( energies.size() ),
+    scl_slope( linear ? energies.size() : 0 ),
+    half_sclslope( linear ? 2 * energies.size() : 0 ),
+    scat_slope( linear ? energies.size() : 0 ),
+    fiss_slope( linear ? energies.size() : 0 ),
+    sweep_slope( linear ? energies.size() : 0 ),
+    half_moments( 2 * scat_order * energies.size() ),
+    flux_moments( scat_order * energies.size() ),
+    scat_moments( scat_order * energies.size() )
+{
+    if( edge )
+    {
+        // Each half of the ordinates starts at the guess of the full angular
+        // flux, half the scalar flux guess
+        const unsigned int half = quadrature.Order() / 2;
+        double neg_sum = 0.0;
+        double pos_sum = 0.0;
+        for( unsigned int a = 0; a != half; a++ )
         {
-            // Set new midpoint angular flux
-            mid_angle_it->second.second =
-                ( in_angle_it->second.second + 0.25 * segment_.CellWidth() *
-                  ( ext_src_it->second + fiss_src_it->second + scat_src_it->second ) /
-                  in_angle_it->first ) /
-                ( 1.0 + 0.5 * abs_it->second * segment_.CellWidth() / in_angle_it->first );
-            // Set new outgoing angular flux
-            out_angle_it->second.second = 2.0 * mid_angle_it->second.second - in_angle_it->second.second;
+            neg_sum += quadrature.Weights()[ a ] * 0.5 * scl_flux_guess;
+            pos_sum += quadrature.Weights()[ half + a ] * 0.5 * scl_flux_guess;
         }
+        half_sclflux.assign( energies.size(), neg_sum );
+        half_sclflux.insert( half_sclflux.end(), energies.size(), pos_sum );
+        scl_flux.assign( energies.size(), neg_sum + pos_sum );
+        prev_mid_sclflux = scl_flux;
+    }
+    else
+    {
+        mid_angflux.reset( new AngularFlux( energies, quadrature, scl_flux_guess, precision ) );
+        out_angflux.reset( new AngularFlux( energies, quadrature, scl_flux_guess, precision ) );
+        prev_mid_sclflux = mid_angflux->ScalarFluxValues();
+    }
+    for( double &value : prev_mid_sclflux )
+    {
+        value *= 10.0;
     }
 }
 
-// [Adjoint] Sweep right
-void Cell::AdjSweepRight( const AngularFlux &adj_in_angflux )
-{
-    adj_prev_mid_sclflux_ = adj_mid_angflux_.ScalarFluxReference();
-    // Set up energy iterators
-    std::map<double,double>::const_iterator adj_ext_src_it = adj_mid_ext_src_.slowest();
-    std::map<double,double>::const_iterator adj_fiss_src_it = adj_mid_fiss_src_.slowest();
-    std::map<double,double>::const_iterator adj_scat_src_it = adj_mid_scat_src_.slowest();
-    std::map<double,double>::const_iterator abs_it = material_.TotMacroXsec().slowest();
-    std::map<double,AngleDependent>::const_iterator adj_in_energy_it = adj_in_angflux.slowest();
-    std::map<double,AngleDependent>::iterator adj_mid_energy_it = adj_mid_angflux_.slowest();
-    std::map<double,AngleDependent>::iterator adj_out_energy_it = adj_out_angflux_.slowest();
-    // Loop through each energy
-    for( ;
-            adj_in_energy_it != std::next( adj_in_angflux.fastest() );
-            adj_ext_src_it++,
-            adj_fiss_src_it++,
-            adj_scat_src_it++,
-            abs_it++,
-            adj_in_energy_it++,
-            adj_mid_energy_it++,
-            adj_out_energy_it++ )
-    {
-        // Set up angle iterators
-        std::map<double,std::pair<double,double>>::const_iterator adj_in_angle_it = adj_in_energy_it->second.neg_begin();
-        std::map<double,std::pair<double,double>>::iterator adj_mid_angle_it = adj_mid_energy_it->second.neg_begin();
-        std::map<double,std::pair<double,double>>::iterator adj_out_angle_it = adj_out_energy_it->second.neg_begin();
-        // Loop through each angle
-        for( ; adj_in_angle_it != adj_in_energy_it->second.neg_end(); adj_in_angle_it++, adj_mid_angle_it++, adj_out_angle_it++ )
+// Return memory used by a transport state (bytes)
+std::size_t Cell::State::MemoryUsage() const
+{
+    std::size_t bytes = mid_angflux ? mid_angflux->MemoryUsage() : 0;
+    bytes += out_angflux ? out_angflux->MemoryUsage() : 0;
+    bytes += sizeof( double ) * ( scl_flux.capacity() + half_sclflux.capacity() + ext_src.capacity() );
+    bytes += sizeof( double ) * ( prev_mid_sclflux.capacity() + scat_src.capacity() );
+    bytes += sizeof( double ) * ( fiss_src.capacity() + sweep_src.capacity() );
+    bytes += sizeof( double ) * ( scl_slope.capacity() + half_sclslope.capacity() + scat_slope.capacity() );
+    bytes += sizeof( double ) * ( fiss_slope.capacity() + sweep_slope.capacity() );
+    bytes += sizeof( double ) * ( half_moments.capacity() + flux_moments.capacity() + scat_moments.capacity() );
+    return bytes;
+}
+
+// Sweep in direction D given the incoming angular flux
+template<Sense S, Direction D>
+void Cell::Sweep( const AngularFlux &in_angflux, const SweepKernels &kernels )
+{
+    State &state = StateReference<S>();
+    SavePreviousScalarFlux( state );
+    GatherSource( state );
+    SweepHalf( SweepPolicy<S,D>::positive, in_angflux, *state.mid_angflux, *state.out_angflux, state, kernels );
+}
+
+// Sweep forward and adjoint fluxes in direction D in a single pass
+template<Direction D>
+void Cell::FusedSweep( const AngularFlux &in_angflux, const AngularFlux &adj_in_angflux, const SweepKernels &kernels )
+{
+    SavePreviousScalarFlux( forward_ );
+    SavePreviousScalarFlux( adjoint_ );
+    GatherSource( forward_ );
+    GatherSource( adjoint_ );
+    FusedSweepHalves( SweepPolicy<FORWARD,D>::positive, in_angflux, *forward_.mid_angflux, *forward_.out_angflux,
+            adj_in_angflux, *adjoint_.mid_angflux, *adjoint_.out_angflux, kernels );
+}
+
+// Sweep in direction D with only edge fluxes stored
+template<Sense S, Direction D>
+void Cell::EdgeSweep( AngularFlux &edge_angflux, AngularFlux &mid_angflux, const SweepKernels &kernels )
+{
+    // The kernels read each incoming value before writing the outgoing one,
+    // so the edge flux is updated in place
+    State &state = StateReference<S>();
+    SavePreviousScalarFlux( state );
+    GatherSource( state );
+    SweepHalf( SweepPolicy<S,D>::positive, edge_angflux, mid_angflux, edge_angflux, state, kernels );
+    UpdateHalfScalarFlux( SweepPolicy<S,D>::positive, mid_angflux, state );
+}
+
+// Sweep forward and adjoint fluxes in direction D in a single pass with only
+// edge fluxes stored
+template<Direction D>
+void Cell::EdgeFusedSweep( AngularFlux &edge_angflux, AngularFlux &mid_angflux, AngularFlux &adj_edge_angflux,
+        AngularFlux &adj_mid_angflux, const SweepKernels &kernels )
+{
+    SavePreviousScalarFlux( forward_ );
+    SavePreviousScalarFlux( adjoint_ );
+    GatherSource( forward_ );
+    GatherSource( adjoint_ );
+    FusedSweepHalves( SweepPolicy<FORWARD,D>::positive, edge_angflux, mid_angflux, edge_angflux, adj_edge_angflux,
+            adj_mid_angflux, adj_edge_angflux, kernels );
+    UpdateHalfScalarFlux( SweepPolicy<FORWARD,D>::positive, mid_angflux, forward_ );
+    UpdateHalfScalarFlux( SweepPolicy<ADJOINT,D>::positive, adj_mid_angflux, adjoint_ );
+}
+
+// Repeat the last sweep in direction D with its sources
+template<Sense S, Direction D>
+void Cell::Resweep( const AngularFlux &in_angflux, const SweepKernels &kernels )
+{
+    // The gathered source is left from the last sweep, so the fluxes are
+    // those the sweep would have stored
+    State &state = StateReference<S>();
+    SweepHalf( SweepPolicy<S,D>::positive, in_angflux, *state.mid_angflux, *state.out_angflux, state, kernels );
+}
+
+// Allocate midpoint and outgoing angular fluxes if they are not stored
+template<Sense S>
+void Cell::AllocateAngularFluxes()
+{
+    State &state = StateReference<S>();
+    if( !state.mid_angflux )
+    {
+        state.mid_angflux.reset( new AngularFlux( Energies(), quadrature_, 0.0, precision_ ) );
+        state.out_angflux.reset( new AngularFlux( Energies(), quadrature_, 0.0, precision_ ) );
+    }
+}
+
+// Free midpoint and outgoing angular fluxes if only edge fluxes are stored
+template<Sense S>
+void Cell::ReleaseAngularFluxes()
+{
+    if( edge_ )
+    {
+        State &state = StateReference<S>();
+        state.mid_angflux.reset();
+        state.out_angflux.reset();
+    }
+}
+
+// Vacuum boundary (incoming on left side)
+template<Sense S>
+void Cell::LeftVacuumBoundary( AngularFlux &bnd_angflux, const SweepKernels &kernels )
+{
+    bnd_angflux.ZeroOrdinates( SweepPolicy<S,RIGHT>::positive );
+    Sweep<S,RIGHT>( bnd_angflux, kernels );
+}
+
+// Reflect boundary (reflecting on left side)
+template<Sense S>
+void Cell::LeftReflectBoundary( AngularFlux &bnd_angflux, const SweepKernels &kernels )
+{
+    bnd_angflux.CopyValues( *StateReference<S>().out_angflux );
+    bnd_angflux.ReflectOrdinates( SweepPolicy<S,RIGHT>::positive );
+    Sweep<S,RIGHT>( bnd_angflux, kernels );
+}
+
+// Vacuum boundary (incoming on right side)
+template<Sense S>
+void Cell::RightVacuumBoundary( AngularFlux &bnd_angflux, const SweepKernels &kernels )
+{
+    bnd_angflux.ZeroOrdinates( SweepPolicy<S,LEFT>::positive );
+    Sweep<S,LEFT>( bnd_angflux, kernels );
+}
+
+// Reflect boundary (reflecting on right side)
+template<Sense S>
+void Cell::RightReflectBoundary( AngularFlux &bnd_angflux, const SweepKernels &kernels )
+{
+    bnd_angflux.CopyValues( *StateReference<S>().out_angflux );
+    bnd_angflux.ReflectOrdinates( SweepPolicy<S,LEFT>::positive );
+    Sweep<S,LEFT>( bnd_angflux, kernels );
+}
+
+// Replace the flux with the isotropic flux of the given midpoint scalar flux
+template<Sense S>
+void Cell::SetScalarFlux( const double *values )
+{
+    State &state = StateReference<S>();
+    const std::size_t num_groups = state.prev_mid_sclflux.size();
+    if( state.mid_angflux )
+    {
+        state.mid_angflux->SetIsotropic( values );
+        state.out_angflux->SetIsotropic( values );
+    }
+    if( edge_ )
+    {
+        // Each half of the weights sums to 1
+        for( std::size_t g = 0; g != num_groups; g++ )
         {
-            // Set new midpoint angular flux
-            adj_mid_angle_it->second.second =
-                ( adj_in_angle_it->second.second - 0.25 * segment_.CellWidth() *
-                  ( adj_ext_src_it->second + adj_fiss_src_it->second + adj_scat_src_it->second ) /
-                  adj_in_angle_it->first ) /
-                ( 1.0 - 0.5 * abs_it->second * segment_.CellWidth() / adj_in_angle_it->first );
-            // Set new outgoing angular flux
-            adj_out_angle_it->second.second = 2.0 * adj_mid_angle_it->second.second - adj_in_angle_it->second.second;
+            state.half_sclflux[ g ] = 0.5 * values[ g ];
+            state.half_sclflux[ num_groups + g ] = 0.5 * values[ g ];
+            state.scl_flux[ g ] = values[ g ];
         }
     }
+    for( std::size_t g = 0; g != num_groups; g++ )
+    {
+        state.prev_mid_sclflux[ g ] = 10.0 * values[ g ];
+    }
+    // An isotropic flux has no moments above P0
+    std::fill( state.half_moments.begin(), state.half_moments.end(), 0.0 );
+    std::fill( state.flux_moments.begin(), state.flux_moments.end(), 0.0 );
 }
 
-// Sweep left
-void Cell::SweepLeft( const AngularFlux &in_angflux )
-{
-    prev_mid_sclflux_ = mid_angflux_.ScalarFluxReference();
-    // Set up energy iterators
-    std::map<double,double>::const_iterator ext_src_it = mid_ext_src_.slowest();
-    std::map<double,double>::const_iterator fiss_src_it = mid_fiss_src_.slowest();
-    std::map<double,double>::const_iterator scat_src_it = mid_scat_src_.slowest();
-    std::map<double,double>::const_iterator abs_it = material_.TotMacroXsec().slowest();
-    std::map<double,AngleDependent>::const_iterator in_energy_it = in_angflux.slowest();
-    std::map<double,AngleDependent>::iterator mid_energy_it = mid_angflux_.slowest();
-    std::map<double,AngleDependent>::iterator out_energy_it = out_angflux_.slowest();
-    // Loop through each energy
-    for( ;
-            in_energy_it != std::next( in_angflux.fastest() );
-            ext_src_it++,
-            fiss_src_it++,
-            scat_src_it++,
-            abs_it++,
-            in_energy_it++,
-            mid_energy_it++,
-            out_energy_it++ )
-    {
-        // Set up angle iterators
-        std::map<double,std::pair<double,double>>::const_iterator in_angle_it = in_energy_it->second.neg_begin();
-        std::map<double,std::pair<double,double>>::iterator mid_angle_it = mid_energy_it->second.neg_begin();
-        std::map<double,std::pair<double,double>>::iterator out_angle_it = out_energy_it->second.neg_begin();
-        // Loop through each angle
-        for( ; in_angle_it != in_energy_it->second.neg_end(); in_angle_it++, mid_angle_it++, out_angle_it++ )
+// Replace the flux with the given midpoint angular flux
+template<Sense S>
+void Cell::SetAngularFlux( const AngularFlux &angflux )
+{
+    State &state = StateReference<S>();
+    if( state.mid_angflux )
+    {
+        state.mid_angflux->CopyValues( angflux );
+        state.out_angflux->CopyValues( angflux );
+    }
+    if( edge_ )
+    {
+        UpdateHalfScalarFlux( false, angflux, state );
+        UpdateHalfScalarFlux( true, angflux, state );
+    }
+    if( scat_order_ != 0 )
+    {
+        UpdateFluxMoments( false, angflux, state );
+        UpdateFluxMoments( true, angflux, state );
+    }
+    const std::vector<double> &scl_flux = ScalarFluxValues( state );
+    for( std::size_t g = 0; g != scl_flux.size(); g++ )
+    {
+        state.prev_mid_sclflux[ g ] = 10.0 * scl_flux[ g ];
+    }
+}
+
+// Add the isotropic flux of the given midpoint scalar flux
+template<Sense S>
+void Cell::AddScalarFlux( const double *values )
+{
+    State &state = StateReference<S>();
+    if( state.mid_angflux )
+    {
+        state.mid_angflux->AddIsotropic( values );
+    }
+    if( edge_ )
+    {
+        const std::size_t num_groups = state.scl_flux.size();
+        for( std::size_t g = 0; g != num_groups; g++ )
         {
-            // Set new midpoint angular flux
-            mid_angle_it->second.second =
-                ( in_angle_it->second.second - 0.25 * segment_.CellWidth() *
-                  ( ext_src_it->second + fiss_src_it->second + scat_src_it->second ) /
-                  in_angle_it->first ) /
-                ( 1.0 - 0.5 * abs_it->second * segment_.CellWidth() / in_angle_it->first );
-            // Set new outgoing angular flux
-            out_angle_it->second.second = 2.0 * mid_angle_it->second.second - in_angle_it->second.second;
+            state.half_sclflux[ g ] += 0.5 * values[ g ];
+            state.half_sclflux[ num_groups + g ] += 0.5 * values[ g ];
+            state.scl_flux[ g ] += values[ g ];
         }
     }
 }
 
-// [Adjoint] Sweep left
-void Cell::AdjSweepLeft( const AngularFlux &adj_in_angflux )
-{
-    adj_prev_mid_sclflux_ = adj_mid_angflux_.ScalarFluxReference();
-    // Set up energy iterators
-    std::map<double,double>::const_iterator adj_ext_src_it = adj_mid_ext_src_.slowest();
-    std::map<double,double>::const_iterator adj_fiss_src_it = adj_mid_fiss_src_.slowest();
-    std::map<double,double>::const_iterator adj_scat_src_it = adj_mid_scat_src_.slowest();
-    std::map<double,double>::const_iterator abs_it = material_.TotMacroXsec().slowest();
-    std::map<double,AngleDependent>::const_iterator adj_in_energy_it = adj_in_angflux.slowest();
-    std::map<double,AngleDependent>::iterator adj_mid_energy_it = adj_mid_angflux_.slowest();
-    std::map<double,AngleDependent>::iterator adj_out_energy_it = adj_out_angflux_.slowest();
-    // Loop through each energy
-    for( ;
-            adj_in_energy_it != std::next( adj_in_angflux.fastest() );
-            adj_ext_src_it++,
-            adj_fiss_src_it++,
-            adj_scat_src_it++,
-            abs_it++,
-            adj_in_energy_it++,
-            adj_mid_energy_it++,
-            adj_out_energy_it++ )
-    {
-        // Set up angle iterators
-        std::map<double,std::pair<double,double>>::const_iterator adj_in_angle_it = adj_in_energy_it->second.pos_begin();
-        std::map<double,std::pair<double,double>>::iterator adj_mid_angle_it = adj_mid_energy_it->second.pos_begin();
-        std::map<double,std::pair<double,double>>::iterator adj_out_angle_it = adj_out_energy_it->second.pos_begin();
-        // Loop through each angle
-        for( ; adj_in_angle_it != adj_in_energy_it->second.pos_end(); adj_in_angle_it++, adj_mid_angle_it++, adj_out_angle_it++ )
+// Return scalar flux error
+template<Sense S>
+double Cell::MaxAbsScalarFluxError()
+{
+    // The first error of greatest magnitude is returned with its sign
+    State &state = StateReference<S>();
+    const std::vector<double> &scl_flux = ScalarFluxValues( state );
+    const std::vector<double> &prev = state.prev_mid_sclflux;
+    double max_error = ( scl_flux[0] - prev[0] ) / prev[0];
+    for( std::size_t g = 1; g < scl_flux.size(); g++ )
+    {
+        double error = ( scl_flux[g] - prev[g] ) / prev[g];
+        if( std::fabs( max_error ) < std::fabs( error ) )
         {
-            // Set new midpoint angular flux
-            adj_mid_angle_it->second.second =
-                ( adj_in_angle_it->second.second + 0.25 * segment_.CellWidth() *
-                  ( adj_ext_src_it->second + adj_fiss_src_it->second + adj_scat_src_it->second ) /
-                  adj_in_angle_it->first ) /
-                ( 1.0 + 0.5 * abs_it->second * segment_.CellWidth() / adj_in_angle_it->first );
-            // Set new outgoing angular flux
-            adj_out_angle_it->second.second = 2.0 * adj_mid_angle_it->second.second - adj_in_angle_it->second.second;
+            max_error = error;
         }
     }
+    return max_error;
 }
 
-// Vacuum boundary (incoming on left side)
-void Cell::LeftVacuumBoundary()
+// Update midpoint scattering source term
+template<Sense S>
+void Cell::UpdateMidpointScatteringSource()
+{
+    State &state = StateReference<S>();
+    const FlatMaterial &material = segment_.FlatMaterialReference();
+    const ScatteringKernel &scat_kernel = S == FORWARD ? material.ScatKernel() : material.AdjScatKernel();
+    scat_kernel.Apply( ScalarFluxValues( state ).data(), state.scat_src.data() );
+    if( linear_ )
+    {
+        scat_kernel.Apply( state.scl_slope.data(), state.scat_slope.data() );
+    }
+    // Moments the material does not scatter into stay zero
+    const std::size_t num_groups = state.scat_src.size();
+    for( unsigned int l = 1; l <= scat_order_ && l <= material.ScatOrder(); l++ )
+    {
+        const ScatteringKernel &moment_kernel = S == FORWARD ? material.ScatMomentKernel( l ) :
+            material.AdjScatMomentKernel( l );
+        moment_kernel.Apply( state.flux_moments.data() + ( l - 1 ) * num_groups,
+                state.scat_moments.data() + ( l - 1 ) * num_groups );
+    }
+}
+
+// Update midpoint fission source term
+template<Sense S>
+void Cell::UpdateMidpointFissionSource( double k )
 {
-    // Create angular flux at boundary
-    AngularFlux in_angflux( material_.TotMacroXsec(), 0.0 );
-    SweepRight( in_angflux );
+    // Forward neutrons are produced by nu * fission and emitted into chi. The
+    // adjoint swaps the roles of the production and emission spectra.
+    State &state = StateReference<S>();
+    const FlatMaterial &material = segment_.FlatMaterialReference();
+    const std::vector<double> &production = S == FORWARD ? material.FissProduction() : material.FissChi();
+    const std::vector<double> &emission = S == FORWARD ? material.FissChi() : material.FissProduction();
+    const std::vector<double> &scl_flux = ScalarFluxValues( state );
+    double rate = 0.0;
+    for( std::size_t g = 0; g < scl_flux.size(); g++ )
+    {
+        rate += production[g] * scl_flux[g];
+    }
+    rate /= k;
+    for( std::size_t g = 0; g < state.fiss_src.size(); g++ )
+    {
+        state.fiss_src[g] = emission[g] * rate;
+    }
+    if( linear_ )
+    {
+        double slope_rate = 0.0;
+        for( std::size_t g = 0; g < state.scl_slope.size(); g++ )
+        {
+            slope_rate += production[g] * state.scl_slope[g];
+        }
+        slope_rate /= k;
+        for( std::size_t g = 0; g < state.fiss_slope.size(); g++ )
+        {
+            state.fiss_slope[g] = emission[g] * slope_rate;
+        }
+    }
 }
 
-// [Adjoint] Vacuum boundary (outgoing on left side)
-void Cell::AdjLeftVacuumBoundary()
+// Scale midpoint fission source term
+template<Sense S>
+void Cell::ScaleFissionSource( double factor )
 {
-    // Create angular flux at boundary
-    AngularFlux in_angflux( material_.TotMacroXsec(), 0.0 );
-    AdjSweepRight( in_angflux );
+    State &state = StateReference<S>();
+    for( double &value : state.fiss_src )
+    {
+        value *= factor;
+    }
+    for( double &value : state.fiss_slope )
+    {
+        value *= factor;
+    }
 }
 
-// Reflect boundary (reflecting on left side, negative->positive)
-void Cell::LeftReflectBoundary()
+// Return memory used (bytes)
+std::size_t Cell::MemoryUsage() const
 {
-    // Create angular flux at boundary
-    AngularFlux in_angflux = out_angflux_;
-    in_angflux.LeftReflectBoundary();
-    SweepRight( in_angflux );
+    return sizeof( Cell ) + forward_.MemoryUsage() + adjoint_.MemoryUsage();
 }
 
-// [Adjoint] Reflect boundary (reflecting on left side, positive->negative)
-void Cell::AdjLeftReflectBoundary()
+// Return cell fission source
+template<Sense S>
+double Cell::FissionSource() const
 {
-    // Create angular flux at boundary
-    AngularFlux in_angflux = adj_out_angflux_;
-    in_angflux.AdjLeftReflectBoundary();
-    AdjSweepRight( in_angflux );
+    const std::vector<double> &fiss_src = StateReference<S>().fiss_src;
+    return std::accumulate( fiss_src.begin(), fiss_src.end(), 0.0 ) * segment_.CellWidth();
 }
 
-// Reflect boundary (reflecting on right side, positive->negative)
-void Cell::RightReflectBoundary()
+// Return midpoint scalar flux at energy, zero if there is no group at energy
+template<Sense S>
+double Cell::ScalarFluxAt( double energy )
 {
-    // Create angular flux at boundary
-    AngularFlux in_angflux = out_angflux_;
-    in_angflux.RightReflectBoundary();
-    SweepLeft( in_angflux );
+    const std::vector<double> &energies = Energies();
+    auto energy_it = std::find( energies.begin(), energies.end(), energy );
+    return energy_it != energies.end() ? ScalarFluxValues<S>()[ energy_it - energies.begin() ] : 0.0;
 }
 
-// [Adjoint] Reflect boundary (reflecting on right side, negative->positive)
-void Cell::AdjRightReflectBoundary()
+// Return midpoint scalar flux (allocates)
+template<Sense S>
+GroupDependent Cell::ScalarFlux()
 {
-    // Create angular flux at boundary
-    AngularFlux in_angflux = adj_out_angflux_;
-    in_angflux.AdjRightReflectBoundary();
-    AdjSweepLeft( in_angflux );
+    const std::vector<double> &values = ScalarFluxValues<S>();
+    GroupDependent scl_flux;
+    for( std::size_t g = 0; g != values.size(); g++ )
+    {
+        scl_flux.Set( Energies()[ g ], values[ g ] );
+    }
+    return scl_flux;
 }
 
-// Return scalar flux error
-double Cell::MaxAbsScalarFluxError()
+// Set external source to given value
+template<Sense S>
+void Cell::SetExternalSource( const GroupDependent &value )
 {
-    GroupDependent rel_errors = RelativeError( mid_angflux_.ScalarFluxReference(),  prev_mid_sclflux_ );
-    return rel_errors.MaxAbs();
+    std::vector<double> &ext_src = StateReference<S>().ext_src;
+    std::vector<double>::iterator src_it = ext_src.begin();
+    for( auto value_it = value.slowest(); value_it != std::next( value.fastest() ); value_it++, src_it++ )
+    {
+        *src_it = value_it->second;
+    }
 }
 
-// [Adjoint] Return scalar flux error
-double Cell::AdjMaxAbsScalarFluxError()
+// Set external source to given values
+template<Sense S>
+void Cell::SetExternalSource( const double *values )
 {
-    GroupDependent rel_errors = RelativeError( adj_mid_angflux_.ScalarFluxReference(),  adj_prev_mid_sclflux_ );
-    return rel_errors.MaxAbs();
+    std::vector<double> &ext_src = StateReference<S>().ext_src;
+    std::copy( values, values + ext_src.size(), ext_src.begin() );
 }
 
-// Update midpoint scattering source term
-void Cell::UpdateMidpointScatteringSource()
+// Write the change of the midpoint scattering source since it was last updated
+template<Sense S>
+void Cell::ScatteringSourceChange( double *values )
+{
+    State &state = StateReference<S>();
+    const FlatMaterial &material = segment_.FlatMaterialReference();
+    const ScatteringKernel &scat_kernel = S == FORWARD ? material.ScatKernel() : material.AdjScatKernel();
+    scat_kernel.Apply( ScalarFluxValues( state ).data(), values );
+    for( std::size_t g = 0; g != state.scat_src.size(); g++ )
+    {
+        values[ g ] -= state.scat_src[ g ];
+    }
+}
+
+// Write the midpoint scattering source of the given scalar flux
+template<Sense S>
+void Cell::ScatteringSource( const double *values, double *source ) const
+{
+    const FlatMaterial &material = segment_.FlatMaterialReference();
+    const ScatteringKernel &scat_kernel = S == FORWARD ? material.ScatKernel() : material.AdjScatKernel();
+    scat_kernel.Apply( values, source );
+}
+
+// Gather total isotropic source of a state for the sweep kernels
+void Cell::GatherSource( State &state )
+{
+    for( std::size_t g = 0; g < state.sweep_src.size(); g++ )
+    {
+        state.sweep_src[g] = state.ext_src[g] + state.fiss_src[g] + state.scat_src[g];
+    }
+    // External sources are flat within a cell
+    for( std::size_t g = 0; g < state.sweep_slope.size(); g++ )
+    {
+        state.sweep_slope[g] = state.fiss_slope[g] + state.scat_slope[g];
+    }
+}
+
+// Copy scalar flux of a state before it is swept
+void Cell::SavePreviousScalarFlux( State &state )
+{
+    const std::vector<double> &scl_flux = ScalarFluxValues( state );
+    std::copy( scl_flux.begin(), scl_flux.end(), state.prev_mid_sclflux.begin() );
+}
+
+// Replace the scalar flux of the swept half of the ordinates of a state with
+// that of the midpoint angular flux
+void Cell::UpdateHalfScalarFlux( bool positive, const AngularFlux &mid_angflux, State &state )
 {
-    mid_scat_src_ = material_.MacroScatXsec() * mid_angflux_.ScalarFluxReference();
+    const std::size_t num_groups = state.scl_flux.size();
+    mid_angflux.HalfScalarFlux( positive, state.half_sclflux.data() + ( positive ? num_groups : 0 ) );
+    for( std::size_t g = 0; g != num_groups; g++ )
+    {
+        state.scl_flux[ g ] = state.half_sclflux[ g ] + state.half_sclflux[ num_groups + g ];
+    }
 }
 
-// [Adjoint] Update midpoint scattering source term
-void Cell::AdjUpdateMidpointScatteringSource()
+// Sum the linear moments of the scalar flux of both halves of the ordinates of
+// a state
+void Cell::UpdateScalarSlope( State &state )
 {
-    adj_mid_scat_src_ = material_.AdjMacroScatXsec() * adj_mid_angflux_.ScalarFluxReference();
+    const std::size_t num_groups = state.scl_slope.size();
+    for( std::size_t g = 0; g != num_groups; g++ )
+    {
+        state.scl_slope[ g ] = state.half_sclslope[ g ] + state.half_sclslope[ num_groups + g ];
+    }
 }
 
-void Cell::UpdateMidpointFissionSource()
+// Replace the flux moments of the swept half of the ordinates of a state with
+// those of the midpoint angular flux
+void Cell::UpdateFluxMoments( bool positive, const AngularFlux &mid_angflux, State &state )
 {
-    double fission_rate = Dot( material_.FissNu() * material_.MacroFissXsec(),  mid_angflux_.ScalarFluxReference() ) / k_;
-    mid_fiss_src_ = material_.FissChi() * fission_rate;
+    const std::size_t size = state.flux_moments.size();
+    mid_angflux.HalfMoments( positive, scat_order_, state.half_moments.data() + ( positive ? size : 0 ) );
+    for( std::size_t i = 0; i != size; i++ )
+    {
+        state.flux_moments[ i ] = state.half_moments[ i ] + state.half_moments[ size + i ];
+    }
 }
 
-void Cell::AdjUpdateMidpointFissionSource()
+// Sweep one half of the ordinates of a state between the given angular fluxes
+void Cell::SweepHalf( bool positive, const AngularFlux &in_angflux, AngularFlux &mid_angflux,
+        AngularFlux &out_angflux, State &state, const SweepKernels &kernels )
 {
-    double adj_fission_rate = Dot( material_.FissChi(),  adj_mid_angflux_.ScalarFluxReference() ) / adj_k_;
-    adj_mid_fiss_src_ = material_.FissNu() * material_.MacroFissXsec() * adj_fission_rate;
+    if( precision_ == Settings::FLOAT )
+    {
+        SweepArguments<float> args;
+        FillSweepArguments( positive, in_angflux.FloatData(), mid_angflux.FloatData(), out_angflux.FloatData(), state,
+                args );
+        kernels.float_single( args );
+    }
+    else
+    {
+        SweepArguments<double> args;
+        FillSweepArguments( positive, in_angflux.Data(), mid_angflux.Data(), out_angflux.Data(), state, args );
+        kernels.single( args );
+    }
+    if( linear_ )
+    {
+        UpdateScalarSlope( state );
+    }
+    if( scat_order_ != 0 )
+    {
+        UpdateFluxMoments( positive, mid_angflux, state );
+    }
 }
 
+// Sweep one half of the ordinates of the forward state and the other half of
+// the adjoint state in a single pass
+void Cell::FusedSweepHalves( bool positive, const AngularFlux &in_angflux, AngularFlux &mid_angflux,
+        AngularFlux &out_angflux, const AngularFlux &adj_in_angflux, AngularFlux &adj_mid_angflux,
+        AngularFlux &adj_out_angflux, const SweepKernels &kernels )
+{
+    if( precision_ == Settings::FLOAT )
+    {
+        FusedSweepArguments<float> args;
+        FillSweepArguments( positive, in_angflux.FloatData(), mid_angflux.FloatData(), out_angflux.FloatData(),
+                forward_, args.forward );
+        FillSweepArguments( !positive, adj_in_angflux.FloatData(), adj_mid_angflux.FloatData(),
+                adj_out_angflux.FloatData(), adjoint_, args.adjoint );
+        kernels.float_fused( args );
+    }
+    else
+    {
+        FusedSweepArguments<double> args;
+        FillSweepArguments( positive, in_angflux.Data(), mid_angflux.Data(), out_angflux.Data(), forward_,
+                args.forward );
+        FillSweepArguments( !positive, adj_in_angflux.Data(), adj_mid_angflux.Data(), adj_out_angflux.Data(),
+                adjoint_, args.adjoint );
+        kernels.fused( args );
+    }
+    if( linear_ )
+    {
+        UpdateScalarSlope( forward_ );
+        UpdateScalarSlope( adjoint_ );
+    }
+    if( scat_order_ != 0 )
+    {
+        UpdateFluxMoments( positive, mid_angflux, forward_ );
+        UpdateFluxMoments( !positive, adj_mid_angflux, adjoint_ );
+    }
+}
+
+// Fill kernel arguments for sweeping one half of the ordinates of a state
+// between the given angular flux values
+template<typename T>
+void Cell::FillSweepArguments( bool positive, const T *in, T *mid, T *out, State &state,
+        SweepArguments<T> &args ) const
+{
+    // Positive ordinates are stored in the second half of each group
+    const unsigned int order = quadrature_.Order();
+    const unsigned int offset = positive ? order / 2 : 0;
+    args.num_groups = state.sweep_src.size();
+    args.num_angles = order / 2;
+    args.stride = order;
+    args.width = segment_.CellWidth();
+    args.inv_mu = quadrature_.InverseAbsOrdinates().data() + offset;
+    args.source = state.sweep_src.data();
+    args.tot_xsec = segment_.FlatMaterialReference().TotMacroXsec().data();
+    args.in = in + offset;
+    args.mid = mid + offset;
+    args.out = out + offset;
+    args.source_slope = state.sweep_slope.data();
+    args.sign = positive ? 1.0 : -1.0;
+    args.weights = quadrature_.Weights().data() + offset;
+    args.slope_sum = linear_ ? state.half_sclslope.data() + ( positive ? state.sweep_src.size() : 0 ) : nullptr;
+    const double *coefficients = characteristic_ ? characteristic_->data() + offset : nullptr;
+    const std::size_t block = characteristic_ ? characteristic_->size() / 4 : 0;
+    args.out_in = coefficients;
+    args.out_source = coefficients + block;
+    args.mid_in = coefficients + 2 * block;
+    args.mid_source = coefficients + 3 * block;
+    args.num_moments = scat_order_;
+    args.moment_source = state.scat_moments.data();
+    args.moment_to_discrete = quadrature_.MomentToDiscrete().data() + offset;
+}
+
+// Explicit instantiations //
+
+template void Cell::Sweep<FORWARD,RIGHT>( const AngularFlux &in_angflux, const SweepKernels &kernels );
+template void Cell::Sweep<FORWARD,LEFT>( const AngularFlux &in_angflux, const SweepKernels &kernels );
+template void Cell::Sweep<ADJOINT,RIGHT>( const AngularFlux &in_angflux, const SweepKernels &kernels );
+template void Cell::Sweep<ADJOINT,LEFT>( const AngularFlux &in_angflux, const SweepKernels &kernels );
+template void Cell::FusedSweep<RIGHT>( const AngularFlux &in_angflux, const AngularFlux &adj_in_angflux, const SweepKernels &kernels );
+template void Cell::FusedSweep<LEFT>( const AngularFlux &in_angflux, const AngularFlux &adj_in_angflux, const SweepKernels &kernels );
+template void Cell::EdgeSweep<FORWARD,RIGHT>( AngularFlux &edge_angflux, AngularFlux &mid_angflux, const SweepKernels &kernels );
+template void Cell::EdgeSweep<FORWARD,LEFT>( AngularFlux &edge_angflux, AngularFlux &mid_angflux, const SweepKernels &kernels );
+template void Cell::EdgeSweep<ADJOINT,RIGHT>( AngularFlux &edge_angflux, AngularFlux &mid_angflux, const SweepKernels &kernels );
+template void Cell::EdgeSweep<ADJOINT,LEFT>( AngularFlux &edge_angflux, AngularFlux &mid_angflux, const SweepKernels &kernels );
+template void Cell::EdgeFusedSweep<RIGHT>( AngularFlux &edge_angflux, AngularFlux &mid_angflux,
+        AngularFlux &adj_edge_angflux, AngularFlux &adj_mid_angflux, const SweepKernels &kernels );
+template void Cell::EdgeFusedSweep<LEFT>( AngularFlux &edge_angflux, AngularFlux &mid_angflux,
+        AngularFlux &adj_edge_angflux, AngularFlux &adj_mid_angflux, const SweepKernels &kernels );
+template void Cell::Resweep<FORWARD,RIGHT>( const AngularFlux &in_angflux, const SweepKernels &kernels );
+template void Cell::Resweep<FORWARD,LEFT>( const AngularFlux &in_angflux, const SweepKernels &kernels );
+template void Cell::Resweep<ADJOINT,RIGHT>( const AngularFlux &in_angflux, const SweepKernels &kernels );
+template void Cell::Resweep<ADJOINT,LEFT>( const AngularFlux &in_angflux, const SweepKernels &kernels );
+template void Cell::AllocateAngularFluxes<FORWARD>();
+template void Cell::AllocateAngularFluxes<ADJOINT>();
+template void Cell::ReleaseAngularFluxes<FORWARD>();
+template void Cell::ReleaseAngularFluxes<ADJOINT>();
+template void Cell::LeftVacuumBoundary<FORWARD>( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+template void Cell::LeftVacuumBoundary<ADJOINT>( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+template void Cell::LeftReflectBoundary<FORWARD>( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+template void Cell::LeftReflectBoundary<ADJOINT>( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+template void Cell::RightVacuumBoundary<FORWARD>( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+template void Cell::RightVacuumBoundary<ADJOINT>( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+template void Cell::RightReflectBoundary<FORWARD>( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+template void Cell::RightReflectBoundary<ADJOINT>( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+template void Cell::SetScalarFlux<FORWARD>( const double *values );
+template void Cell::SetScalarFlux<ADJOINT>( const double *values );
+template void Cell::SetAngularFlux<FORWARD>( const AngularFlux &angflux );
+template void Cell::SetAngularFlux<ADJOINT>( const AngularFlux &angflux );
+template void Cell::AddScalarFlux<FORWARD>( const double *values );
+template void Cell::AddScalarFlux<ADJOINT>( const double *values );
+template double Cell::MaxAbsScalarFluxError<FORWARD>();
+template double Cell::MaxAbsScalarFluxError<ADJOINT>();
+template void Cell::UpdateMidpointScatteringSource<FORWARD>();
+template void Cell::UpdateMidpointScatteringSource<ADJOINT>();
+template void Cell::UpdateMidpointFissionSource<FORWARD>( double k );
+template void Cell::UpdateMidpointFissionSource<ADJOINT>( double k );
+template void Cell::ScaleFissionSource<FORWARD>( double factor );
+template void Cell::ScaleFissionSource<ADJOINT>( double factor );
+template double Cell::FissionSource<FORWARD>() const;
+template double Cell::FissionSource<ADJOINT>() const;
+template double Cell::ScalarFluxAt<FORWARD>( double energy );
+template double Cell::ScalarFluxAt<ADJOINT>( double energy );
+template GroupDependent Cell::ScalarFlux<FORWARD>();
+template GroupDependent Cell::ScalarFlux<ADJOINT>();
+template void Cell::SetExternalSource<FORWARD>( const GroupDependent &value );
+template void Cell::SetExternalSource<ADJOINT>( const GroupDependent &value );
+template void Cell::SetExternalSource<FORWARD>( const double *values );
+template void Cell::SetExternalSource<ADJOINT>( const double *values );
+template void Cell::ScatteringSourceChange<FORWARD>( double *values );
+template void Cell::ScatteringSourceChange<ADJOINT>( double *values );
+template void Cell::ScatteringSource<FORWARD>( const double *values, double *source ) const;
+template void Cell::ScatteringSource<ADJOINT>( const double *values, double *source ) const;
+
 // Friend functions //
 
 // Overload operator<<()
@@ -293,10 +684,17 @@ std::ostream &operator<< ( std::ostream &out, const Cell &obj )
 {
     out << "Cell address: " << &obj << "\t";
     out << "Segment address: " << &obj.segment_ << "\t";
-    out << "Settings address: " << &obj.settings_ << "\t";
-    std::cout << std::endl;
-    std::cout << "Midpoint flux:\n\n" << obj.mid_angflux_ << std::endl;
-    std::cout << "Outgoing flux:\n\n" << obj.out_angflux_ << std::endl;
-    std::cout << "Scalar flux:\n\n" << obj.prev_mid_sclflux_ << std::endl;
+    out << std::endl;
+    if( obj.forward_.mid_angflux )
+    {
+        out << "Midpoint flux:\n\n" << *obj.forward_.mid_angflux << std::endl;
+        out << "Outgoing flux:\n\n" << *obj.forward_.out_angflux << std::endl;
+    }
+    out << "Scalar flux:\n\n";
+    for( double value : obj.forward_.prev_mid_sclflux )
+    {
+        out << value << "\t";
+    }
+    out << std::endl;
     return out;
 }
@@ -4,100 +4,188 @@
 #pragma once
 
 // std includes
+#include <cstddef>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <vector>
 
 // biscotti includes
 #include "angularflux.hpp"
+#include "groupdependent.hpp"
+#include "quadrature.hpp"
 #include "segment.hpp"
 #include "settings.hpp"
-
+#include "sweepkernel.hpp"
+
+// A single spatial cell. Everything shared by the cells of a segment (width,
+// material and external source defaults) is read through the segment; a cell
+// only owns the flux and source state that changes during a solve. When only
+// edge fluxes are stored, the midpoint and outgoing angular fluxes are dropped
+// and each cell keeps the scalar flux of both halves of the ordinates instead.
+// Angular fluxes are swept with the kernels of their storage precision. With the
+// linear discontinuous scheme each cell also keeps the linear moment of its
+// scalar flux and sources. With the step characteristic scheme the cells of a
+// segment share their precomputed kernel coefficients. With anisotropic
+// scattering each cell also keeps the Legendre moments of its flux and
+// scattering source above P0.
 class Cell
 {
     public:
 
-        // Default constructor
-        Cell( const Settings &settings, const Segment &segment, const double &k, const double &adj_k );
-
-        // Sweep right
-        void SweepRight( const AngularFlux &in_angflux );
-
-        // [Adjoint] Sweep right
-        void AdjSweepRight( const AngularFlux &in_angflux );
-
-        // Sweep left
-        void SweepLeft( const AngularFlux &in_angflux );
-
-        // [Adjoint] Sweep left
-        void AdjSweepLeft( const AngularFlux &in_angflux );
-
-        // Vacuum boundary (incoming on left side)
-        void LeftVacuumBoundary();
-
-        // [Adjoint] Vacuum boundary (outgoing on left side)
-        void AdjLeftVacuumBoundary();
-
-        // Reflect boundary (reflecting on left side, negative->positive)
-        void LeftReflectBoundary();
-
-        // [Adjoint] Reflect boundary (reflecting on left side, positive->negative)
-        void AdjLeftReflectBoundary();
-
-        // Reflect boundary (reflecting on right side, positive->negative)
-        void RightReflectBoundary();
-
-        // [Adjoint] Reflect boundary (reflecting on right side, negative->positive)
-        void AdjRightReflectBoundary();
+        // Default constructor. The step characteristic scheme requires the
+        // coefficients from StepCharacteristicCoefficients() for the segment.
+        Cell( const Segment &segment, const Quadrature &quadrature, const Settings &settings,
+                std::shared_ptr<const std::vector<double>> characteristic = nullptr );
+
+        // Sweep in direction D given the incoming angular flux
+        template<Sense S, Direction D>
+        void Sweep( const AngularFlux &in_angflux, const SweepKernels &kernels );
+
+        // Sweep forward and adjoint fluxes in direction D in a single pass
+        template<Direction D>
+        void FusedSweep( const AngularFlux &in_angflux, const AngularFlux &adj_in_angflux, const SweepKernels &kernels );
+
+        // Sweep in direction D with only edge fluxes stored. The incoming flux
+        // in edge_angflux is replaced by the outgoing flux, mid_angflux is
+        // scratch for the midpoint flux.
+        template<Sense S, Direction D>
+        void EdgeSweep( AngularFlux &edge_angflux, AngularFlux &mid_angflux, const SweepKernels &kernels );
+
+        // Sweep forward and adjoint fluxes in direction D in a single pass with
+        // only edge fluxes stored
+        template<Direction D>
+        void EdgeFusedSweep( AngularFlux &edge_angflux, AngularFlux &mid_angflux, AngularFlux &adj_edge_angflux,
+                AngularFlux &adj_mid_angflux, const SweepKernels &kernels );
+
+        // Repeat the last sweep in direction D with its sources, storing the
+        // midpoint and outgoing angular fluxes. Angular fluxes must be allocated.
+        template<Sense S, Direction D>
+        void Resweep( const AngularFlux &in_angflux, const SweepKernels &kernels );
+
+        // Allocate midpoint and outgoing angular fluxes if they are not stored
+        template<Sense S>
+        void AllocateAngularFluxes();
+
+        // Free midpoint and outgoing angular fluxes if only edge fluxes are
+        // stored
+        template<Sense S>
+        void ReleaseAngularFluxes();
+
+        // Vacuum boundary (incoming on left side). The incoming flux is built in
+        // bnd_angflux.
+        template<Sense S>
+        void LeftVacuumBoundary( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+
+        // Reflect boundary (reflecting on left side). The incoming flux is
+        // built in bnd_angflux.
+        template<Sense S>
+        void LeftReflectBoundary( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+
+        // Vacuum boundary (incoming on right side). The incoming flux is built
+        // in bnd_angflux.
+        template<Sense S>
+        void RightVacuumBoundary( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+
+        // Reflect boundary (reflecting on right side). The incoming flux is
+        // built in bnd_angflux.
+        template<Sense S>
+        void RightReflectBoundary( AngularFlux &bnd_angflux, const SweepKernels &kernels );
+
+        // Replace the flux with the isotropic flux of the given midpoint scalar
+        // flux, slowest group first
+        template<Sense S>
+        void SetScalarFlux( const double *values );
+
+        // Replace the flux with the given midpoint angular flux, which must be
+        // on the groups, quadrature and precision of the cell
+        template<Sense S>
+        void SetAngularFlux( const AngularFlux &angflux );
+
+        // Add the isotropic flux of the given midpoint scalar flux, slowest
+        // group first, without counting it as a change of the last sweep
+        template<Sense S>
+        void AddScalarFlux( const double *values );
 
         // Return scalar flux error
+        template<Sense S>
         double MaxAbsScalarFluxError();
 
-        // [Adjoint] Return scalar flux error
-        double AdjMaxAbsScalarFluxError();
-
         // Update midpoint scattering source term
+        template<Sense S>
         void UpdateMidpointScatteringSource();
 
-        // [Adjoint] Update midpoint scattering source term
-        void AdjUpdateMidpointScatteringSource();
+        // Update midpoint fission source term given the k eigenvalue
+        template<Sense S>
+        void UpdateMidpointFissionSource( double k );
 
-        // Update midpoint fission source term
-        void UpdateMidpointFissionSource();
+        // Scale midpoint fission source term by factor
+        template<Sense S>
+        void ScaleFissionSource( double factor );
 
-        // [Adjoint] Update midpoint fission source term
-        void AdjUpdateMidpointFissionSource();
+        // Return memory used (bytes)
+        std::size_t MemoryUsage() const;
 
         // Accessors and mutators //
 
         // Return cell width
         double Width() const { return segment_.CellWidth(); };
 
-        // Return cell fission source
-        double FissionSource() const { return mid_fiss_src_.GroupSum() * segment_.CellWidth(); };
+        // Return energy groups (eV), slowest group first
+        const std::vector<double> &Energies() const { return segment_.FlatMaterialReference().Energies(); };
+
+        // Return const reference to quadrature
+        const Quadrature &QuadratureReference() const { return quadrature_; };
 
-        // [Adjoint] Return cell fission source
-        double AdjFissionSource() const { return adj_mid_fiss_src_.GroupSum() * segment_.CellWidth(); };
+        // Return scalar flux guess
+        template<Sense S>
+        double ScalarFluxGuess() const { return S == FORWARD ? segment_.ScalarFluxGuess() : segment_.AdjScalarFluxGuess(); };
+
+        // Return midpoint scalar flux, slowest group first
+        template<Sense S>
+        const std::vector<double> &ScalarFluxValues() { return ScalarFluxValues( StateReference<S>() ); };
+
+        // Return midpoint scalar flux at energy, zero if there is no group at
+        // energy
+        template<Sense S>
+        double ScalarFluxAt( double energy );
+
+        // Return midpoint scalar flux (allocates)
+        template<Sense S>
+        GroupDependent ScalarFlux();
+
+        // Return cell fission source
+        template<Sense S>
+        double FissionSource() const;
 
         // Set external source to given value
-        void SetExternalSource( const GroupDependent &value ) { mid_ext_src_ = value; };
+        template<Sense S>
+        void SetExternalSource( const GroupDependent &value );
 
-        // [Adjoint] Set external source to given value
-        void AdjSetExternalSource( const GroupDependent &value ) { adj_mid_ext_src_ = value; };
+        // Set external source to given values, slowest group first
+        template<Sense S>
+        void SetExternalSource( const double *values );
 
-        // Const reference to outgoing angular flux
-        const AngularFlux &OutgoingAngularFluxReference() const { return out_angflux_; };
+        // Write the change of the midpoint scattering source since it was last
+        // updated, as given by the current scalar flux, to values, slowest
+        // group first
+        template<Sense S>
+        void ScatteringSourceChange( double *values );
 
-        // [Adjoint] Const reference to outgoing angular flux
-        const AngularFlux &AdjOutgoingAngularFluxReference() const { return adj_out_angflux_; };
+        // Write the midpoint scattering source of the given scalar flux to
+        // source, both slowest group first
+        template<Sense S>
+        void ScatteringSource( const double *values, double *source ) const;
 
-        // Reference to midpoint angular flux
-        AngularFlux &MidpointAngularFluxReference() { return mid_angflux_; };
+        // Const reference to outgoing angular flux
+        template<Sense S>
+        const AngularFlux &OutgoingAngularFluxReference() const { return *StateReference<S>().out_angflux; };
 
-        // [Adjoint] Reference to midpoint angular flux
-        AngularFlux &AdjMidpointAngularFluxReference() { return adj_mid_angflux_; };
+        // Reference to midpoint angular flux
+        template<Sense S>
+        AngularFlux &MidpointAngularFluxReference() { return *StateReference<S>().mid_angflux; };
 
         // Const reference to material
-        const Material &MaterialReference() const { return material_; };
+        const Material &MaterialReference() const { return segment_.MaterialReference(); };
 
         // Friend functions //
 
@@ -106,56 +194,156 @@ class Cell
 
     private:
 
-        // Const reference to settings
-        const Settings &settings_;
+        // Transport state of one sense of the problem
+        struct State
+        {
+            // Default constructor
+            State( const std::vector<double> &energies, const Quadrature &quadrature, const std::vector<double> &ext_src,
+                    double scl_flux_guess, bool edge, Settings::Precision precision, bool linear,
+                    unsigned int scat_order );
 
-        // Const reference to segment
-        const Segment &segment_;
+            // Return memory used (bytes)
+            std::size_t MemoryUsage() const;
 
-        // Const reference to material
-        const Material &material_;
+            // Midpoint group angular flux, null if only edge fluxes are stored
+            std::unique_ptr<AngularFlux> mid_angflux;
+
+            // Outgoing boundary group angular flux, null if only edge fluxes
+            // are stored
+            std::unique_ptr<AngularFlux> out_angflux;
 
-        // Const reference to k eigenvalue
-        const double &k_;
+            // Group values below are stored slowest group first
 
-        // [Adjoint] Const reference to k eigenvalue
-        const double &adj_k_;
+            // Midpoint scalar flux if only edge fluxes are stored
+            std::vector<double> scl_flux;
 
-        // External source term
-        GroupDependent mid_ext_src_;
+            // Midpoint scalar flux of the negative then the positive ordinates
+            // if only edge fluxes are stored
+            std::vector<double> half_sclflux;
 
-        // [Adjoint] External source term
-        GroupDependent adj_mid_ext_src_;
+            // External source term
+            std::vector<double> ext_src;
 
-        // Midpoint group angular flux
-        AngularFlux mid_angflux_;
+            // Previous midpoint scalar flux
+            std::vector<double> prev_mid_sclflux;
 
-        // [Adjoint] Midpoint group angular flux
-        AngularFlux adj_mid_angflux_;
+            // Midpoint scattering source term
+            std::vector<double> scat_src;
+
+            // Midpoint fisson source term
+            std::vector<double> fiss_src;
+
+            // Total isotropic source gathered for the sweep kernel
+            std::vector<double> sweep_src;
+
+            // Linear moments below are stored only for the linear
+            // discontinuous scheme
+
+            // Linear moment of the midpoint scalar flux
+            std::vector<double> scl_slope;
+
+            // Linear moment of the scalar flux of the negative then the
+            // positive ordinates
+            std::vector<double> half_sclslope;
+
+            // Linear moment of the scattering source term
+            std::vector<double> scat_slope;
+
+            // Linear moment of the fission source term
+            std::vector<double> fiss_slope;
+
+            // Linear moment of the total isotropic source gathered for the
+            // sweep kernel
+            std::vector<double> sweep_slope;
+
+            // Legendre moments below are stored only for anisotropic
+            // scattering, moments 1 through the scattering order, one block
+            // of groups per moment
+
+            // Midpoint flux moments of the negative then the positive
+            // ordinates
+            std::vector<double> half_moments;
+
+            // Midpoint flux moments
+            std::vector<double> flux_moments;
+
+            // Midpoint scattering source moments
+            std::vector<double> scat_moments;
+        };
+
+        // Reference to transport state of sense S
+        template<Sense S>
+        State &StateReference() { return S == FORWARD ? forward_ : adjoint_; };
+
+        // Const reference to transport state of sense S
+        template<Sense S>
+        const State &StateReference() const { return S == FORWARD ? forward_ : adjoint_; };
+
+        // Midpoint scalar flux of a state
+        const std::vector<double> &ScalarFluxValues( State &state ) { return edge_ ? state.scl_flux : state.mid_angflux->ScalarFluxValues(); };
+
+        // Gather total isotropic source of a state for the sweep kernels
+        static void GatherSource( State &state );
+
+        // Copy scalar flux of a state before it is swept
+        void SavePreviousScalarFlux( State &state );
+
+        // Sum the linear moments of the scalar flux of both halves of the
+        // ordinates of a state
+        static void UpdateScalarSlope( State &state );
+
+        // Replace the flux moments of the swept half of the ordinates of a
+        // state with those of the midpoint angular flux
+        void UpdateFluxMoments( bool positive, const AngularFlux &mid_angflux, State &state );
+
+        // Replace the scalar flux of the swept half of the ordinates of a state
+        // with that of the midpoint angular flux
+        void UpdateHalfScalarFlux( bool positive, const AngularFlux &mid_angflux, State &state );
+
+        // Sweep one half of the ordinates of a state between the given angular
+        // fluxes, which may be the same for in and out
+        void SweepHalf( bool positive, const AngularFlux &in_angflux, AngularFlux &mid_angflux,
+                AngularFlux &out_angflux, State &state, const SweepKernels &kernels );
+
+        // Sweep one half of the ordinates of the forward state and the other
+        // half of the adjoint state in a single pass
+        void FusedSweepHalves( bool positive, const AngularFlux &in_angflux, AngularFlux &mid_angflux,
+                AngularFlux &out_angflux, const AngularFlux &adj_in_angflux, AngularFlux &adj_mid_angflux,
+                AngularFlux &adj_out_angflux, const SweepKernels &kernels );
+
+        // Fill kernel arguments for sweeping one half of the ordinates of a
+        // state between the given angular flux values
+        template<typename T>
+        void FillSweepArguments( bool positive, const T *in, T *mid, T *out, State &state,
+                SweepArguments<T> &args ) const;
+
+        // Const reference to segment
+        const Segment &segment_;
 
-        // Outgoing boundary group angular flux
-        AngularFlux out_angflux_;
+        // Const reference to quadrature
+        const Quadrature &quadrature_;
 
-        // [Adjoint] Outgoing boundary group angular flux
-        AngularFlux adj_out_angflux_;
+        // True if only edge fluxes are stored
+        const bool edge_;
 
-        // Previous midpoint scalar flux
-        GroupDependent prev_mid_sclflux_;
+        // Precision angular fluxes are stored in
+        const Settings::Precision precision_;
 
-        // [Adjoint] Previous midpoint scalar flux
-        GroupDependent adj_prev_mid_sclflux_;
+        // True if linear moments are carried (linear discontinuous scheme)
+        const bool linear_;
 
-        // Midpoint scattering source term
-        GroupDependent mid_scat_src_;
+        // Highest Legendre moment of scattering carried
+        const unsigned int scat_order_;
 
-        // [Adjoint] Midpoint scattering source term
-        GroupDependent adj_mid_scat_src_;
+        // Step characteristic coefficients shared by the cells of the segment,
+        // null for other schemes
+        std::shared_ptr<const std::vector<double>> characteristic_;
 
-        // Midpoint fisson source term
-        GroupDependent mid_fiss_src_;
+        // Forward transport state
+        State forward_;
 
-        // [Adjoint] Midpoint fisson source term
-        GroupDependent adj_mid_fiss_src_;
+        // [Adjoint] Transport state
+        State adjoint_;
 };
 
 // Friend functions //
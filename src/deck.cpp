@@ -0,0 +1,664 @@
+// deck.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// biscotti includes
+#include "deck.hpp"
+#include "slab.hpp"
+
+// Parse constructor (name is used in error messages)
+Deck::Deck( std::istream &in, const std::string &name ):
+    name_( name ),
+    line_number_( 0 )
+{
+    std::string line;
+    while( std::getline( in, line ) )
+    {
+        line_number_++;
+        // Strip comments
+        std::string::size_type comment = line.find( '#' );
+        if( comment != std::string::npos )
+        {
+            line.erase( comment );
+        }
+        // Tokenize line
+        std::istringstream line_stream( line );
+        std::vector<std::string> tokens;
+        std::string token;
+        while( line_stream >> token )
+        {
+            tokens.push_back( token );
+        }
+        if( tokens.empty() )
+        {
+            continue;
+        }
+        if( cur_material_.empty() )
+        {
+            ParseLine( tokens );
+        }
+        else
+        {
+            ParseMaterialLine( tokens );
+        }
+    }
+    // Check deck is complete
+    if( !cur_material_.empty() )
+    {
+        Error( "material '" + cur_material_ + "' is missing 'end'" );
+    }
+    if( layout_.NumSegments() == 0 )
+    {
+        Error( "no segments defined" );
+    }
+    if( solve_modes_.empty() )
+    {
+        Error( "no solve modes requested" );
+    }
+    if( settings_.ScatteringOrder() >= settings_.QuadratureOrder() )
+    {
+        Error( "scattering_order must be below quadrature_order" );
+    }
+    // The Newton unknowns are the isotropic scalar flux alone, so nothing else
+    // may carry over from one sweep to the next: not the flux reflected at the
+    // left boundary, the flux moments above P0 or the linear moments
+    if( std::find( solve_modes_.begin(), solve_modes_.end(), JFNK_EIGENVALUE ) != solve_modes_.end() &&
+            ( settings_.LeftBC() != Settings::VACUUM || settings_.ScatteringOrder() != 0 ||
+              settings_.SpatialScheme() == Settings::LINEAR_DISCONTINUOUS ) )
+    {
+        Error( "jfnk_eigenvalue requires a vacuum left boundary, scattering_order 0 and no linear_discontinuous scheme" );
+    }
+}
+
+// Construct a Slab and perform each requested solve in order
+void Deck::Run() const
+{
+    // A mirror symmetric slab is solved on its left half with a reflecting
+    // midplane, unless a solve mode resolves sources or responses cell by cell
+    bool symmetric = settings_.DetectSymmetry() && settings_.LeftBC() == settings_.RightBC() &&
+        layout_.IsMirrorSymmetric();
+    for( auto it = solve_modes_.begin(); it != solve_modes_.end(); it++ )
+    {
+        symmetric = symmetric && *it != FISSION_MATRIX && *it != FIRST_GENERATION_WEIGHTED_SOURCE &&
+            *it != ADAPTIVE_EIGENVALUE;
+    }
+    Settings settings = settings_;
+    if( symmetric )
+    {
+        std::cout << "Mirror symmetric layout: solving the left half with a reflecting midplane" << std::endl;
+        settings.SetRightBC( Settings::REFLECTING );
+    }
+    Slab slab( settings, symmetric ? layout_.LeftHalf() : layout_, symmetric );
+    for( auto it = solve_modes_.begin(); it != solve_modes_.end(); it++ )
+    {
+        switch( *it )
+        {
+            case EIGENVALUE:
+                slab.EigenvalueSolve();
+                break;
+            case ADJ_EIGENVALUE:
+                slab.AdjEigenvalueSolve();
+                break;
+            case FUSED_EIGENVALUE:
+                slab.FusedEigenvalueSolve();
+                break;
+            case CONCURRENT_EIGENVALUE:
+                slab.ConcurrentEigenvalueSolve();
+                break;
+            case FISSION_MATRIX:
+                slab.FissionMatrixSolve();
+                break;
+            case FIRST_GENERATION_WEIGHTED_SOURCE:
+                slab.FirstGenerationWeightedSourceSolve();
+                break;
+            case FISSION_SOURCE:
+                slab.FissionSourceSolve();
+                break;
+            case MEMORY_REPORT:
+                slab.MemoryReport();
+                break;
+            case PRECISION_REPORT:
+                slab.PrecisionReport();
+                break;
+            case ADAPTIVE_EIGENVALUE:
+                slab.AdaptiveEigenvalueSolve();
+                break;
+            case MESH_SEQUENCED_EIGENVALUE:
+                slab.MeshSequencedEigenvalueSolve();
+                break;
+            case JFNK_EIGENVALUE:
+                slab.JfnkEigenvalueSolve();
+                break;
+        }
+    }
+}
+
+// Parse a single tokenized line
+void Deck::ParseLine( const std::vector<std::string> &tokens )
+{
+    const std::string &key = tokens.front();
+
+    // Settings //
+
+    if( key == "left_bc" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "vacuum" )
+        {
+            settings_.SetLeftBC( Settings::VACUUM );
+        }
+        else if( tokens[1] == "reflecting" )
+        {
+            settings_.SetLeftBC( Settings::REFLECTING );
+        }
+        else
+        {
+            Error( "unknown boundary condition '" + tokens[1] + "'" );
+        }
+    }
+    else if( key == "right_bc" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "vacuum" )
+        {
+            settings_.SetRightBC( Settings::VACUUM );
+        }
+        else if( tokens[1] == "reflecting" )
+        {
+            settings_.SetRightBC( Settings::REFLECTING );
+        }
+        else
+        {
+            Error( "unknown boundary condition '" + tokens[1] + "'" );
+        }
+    }
+    else if( key == "k_guess" )
+    {
+        ExpectTokens( tokens, 2 );
+        settings_.SetKGuess( ReadNumber( tokens[1] ) );
+    }
+    else if( key == "adj_k_guess" )
+    {
+        ExpectTokens( tokens, 2 );
+        settings_.AdjSetKGuess( ReadNumber( tokens[1] ) );
+    }
+    else if( key == "fission_source_guess" )
+    {
+        ExpectTokens( tokens, 2 );
+        settings_.SetFissionSourceGuess( ReadNumber( tokens[1] ) );
+    }
+    else if( key == "adj_fission_source_guess" )
+    {
+        ExpectTokens( tokens, 2 );
+        settings_.AdjSetFissionSourceGuess( ReadNumber( tokens[1] ) );
+    }
+    else if( key == "k_tol" )
+    {
+        ExpectTokens( tokens, 2 );
+        settings_.SetKTol( ReadNumber( tokens[1] ) );
+    }
+    else if( key == "scl_flux_tol" )
+    {
+        ExpectTokens( tokens, 2 );
+        settings_.SetSclFluxTol( ReadNumber( tokens[1] ) );
+    }
+    else if( key == "seed" )
+    {
+        ExpectTokens( tokens, 2 );
+        settings_.SetSeed( (unsigned int) ReadNumber( tokens[1] ) );
+    }
+    else if( key == "progress_period" )
+    {
+        ExpectTokens( tokens, 2 );
+        double period = ReadNumber( tokens[1] );
+        if( period < 1.0 )
+        {
+            Error( "progress_period must be at least 1" );
+        }
+        settings_.SetProgressPeriod( (unsigned int) period );
+    }
+    else if( key == "quadrature_order" )
+    {
+        ExpectTokens( tokens, 2 );
+        double order = ReadNumber( tokens[1] );
+        if( order < 2.0 || std::fmod( order, 2.0 ) != 0.0 )
+        {
+            Error( "quadrature_order must be a positive even number" );
+        }
+        settings_.SetQuadratureOrder( (unsigned int) order );
+    }
+    else if( key == "angular_flux_storage" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "full" )
+        {
+            settings_.SetAngularFluxStorage( Settings::FULL );
+        }
+        else if( tokens[1] == "edge" )
+        {
+            settings_.SetAngularFluxStorage( Settings::EDGE );
+        }
+        else
+        {
+            Error( "unknown angular flux storage '" + tokens[1] + "'" );
+        }
+    }
+    else if( key == "angular_flux_precision" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "double" )
+        {
+            settings_.SetAngularFluxPrecision( Settings::DOUBLE );
+        }
+        else if( tokens[1] == "float" )
+        {
+            settings_.SetAngularFluxPrecision( Settings::FLOAT );
+        }
+        else
+        {
+            Error( "unknown angular flux precision '" + tokens[1] + "'" );
+        }
+    }
+    else if( key == "spatial_scheme" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "diamond_difference" )
+        {
+            settings_.SetSpatialScheme( Settings::DIAMOND_DIFFERENCE );
+        }
+        else if( tokens[1] == "linear_discontinuous" )
+        {
+            settings_.SetSpatialScheme( Settings::LINEAR_DISCONTINUOUS );
+        }
+        else if( tokens[1] == "step_characteristic" )
+        {
+            settings_.SetSpatialScheme( Settings::STEP_CHARACTERISTIC );
+        }
+        else
+        {
+            Error( "unknown spatial scheme '" + tokens[1] + "'" );
+        }
+    }
+    else if( key == "adaptive_levels" )
+    {
+        ExpectTokens( tokens, 2 );
+        double levels = ReadNumber( tokens[1] );
+        if( levels < 0.0 || levels > 20.0 )
+        {
+            Error( "adaptive_levels must be between 0 and 20" );
+        }
+        settings_.SetAdaptiveLevels( (unsigned int) levels );
+    }
+    else if( key == "mesh_sequence_factor" )
+    {
+        ExpectTokens( tokens, 2 );
+        double factor = ReadNumber( tokens[1] );
+        if( factor < 1.0 || factor > 1024.0 || std::fmod( factor, 1.0 ) != 0.0 )
+        {
+            Error( "mesh_sequence_factor must be an integer between 1 and 1024" );
+        }
+        settings_.SetMeshSequenceFactor( (unsigned int) factor );
+    }
+    else if( key == "adaptive_tol" )
+    {
+        ExpectTokens( tokens, 2 );
+        settings_.SetAdaptiveTol( ReadNumber( tokens[1] ) );
+    }
+    else if( key == "scattering_order" )
+    {
+        ExpectTokens( tokens, 2 );
+        double order = ReadNumber( tokens[1] );
+        if( order < 0.0 || std::fmod( order, 1.0 ) != 0.0 )
+        {
+            Error( "scattering_order must be a nonnegative integer" );
+        }
+        settings_.SetScatteringOrder( (unsigned int) order );
+    }
+    else if( key == "symmetry" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "auto" )
+        {
+            settings_.SetDetectSymmetry( true );
+        }
+        else if( tokens[1] == "off" )
+        {
+            settings_.SetDetectSymmetry( false );
+        }
+        else
+        {
+            Error( "unknown symmetry option '" + tokens[1] + "'" );
+        }
+    }
+    else if( key == "initial_guess" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "diffusion" )
+        {
+            settings_.SetDiffusionGuess( true );
+        }
+        else if( tokens[1] == "flat" )
+        {
+            settings_.SetDiffusionGuess( false );
+        }
+        else
+        {
+            Error( "unknown initial guess '" + tokens[1] + "'" );
+        }
+    }
+    else if( key == "inner_acceleration" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "none" )
+        {
+            settings_.SetInnerAcceleration( Settings::NONE );
+        }
+        else if( tokens[1] == "angular_multigrid" )
+        {
+            settings_.SetInnerAcceleration( Settings::ANGULAR_MULTIGRID );
+        }
+        else
+        {
+            Error( "unknown inner acceleration '" + tokens[1] + "'" );
+        }
+    }
+    else if( key == "angular_multigrid_order" )
+    {
+        ExpectTokens( tokens, 2 );
+        double order = ReadNumber( tokens[1] );
+        if( order < 2.0 || std::fmod( order, 2.0 ) != 0.0 )
+        {
+            Error( "angular_multigrid_order must be a positive even number" );
+        }
+        settings_.SetAngularMultigridOrder( (unsigned int) order );
+    }
+    else if( key == "inner_tolerance" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "fixed" )
+        {
+            settings_.SetAdaptiveInnerTol( false );
+        }
+        else if( tokens[1] == "adaptive" )
+        {
+            settings_.SetAdaptiveInnerTol( true );
+        }
+        else
+        {
+            Error( "unknown inner tolerance '" + tokens[1] + "'" );
+        }
+    }
+    else if( key == "inner_tol_ratio" )
+    {
+        ExpectTokens( tokens, 2 );
+        double ratio = ReadNumber( tokens[1] );
+        if( ratio <= 0.0 )
+        {
+            Error( "inner_tol_ratio must be positive" );
+        }
+        settings_.SetInnerTolRatio( ratio );
+    }
+    else if( key == "anderson_depth" )
+    {
+        ExpectTokens( tokens, 2 );
+        double depth = ReadNumber( tokens[1] );
+        if( depth < 0.0 || std::fmod( depth, 1.0 ) != 0.0 )
+        {
+            Error( "anderson_depth must be a nonnegative integer" );
+        }
+        settings_.SetAndersonDepth( (unsigned int) depth );
+    }
+    else if( key == "krylov_size" )
+    {
+        ExpectTokens( tokens, 2 );
+        double size = ReadNumber( tokens[1] );
+        if( size < 1.0 || std::fmod( size, 1.0 ) != 0.0 )
+        {
+            Error( "krylov_size must be a positive integer" );
+        }
+        settings_.SetKrylovSize( (unsigned int) size );
+    }
+    else if( key == "num_threads" )
+    {
+        ExpectTokens( tokens, 2 );
+        double num_threads = ReadNumber( tokens[1] );
+        if( num_threads < 1.0 || std::fmod( num_threads, 1.0 ) != 0.0 )
+        {
+            Error( "num_threads must be a positive integer" );
+        }
+        settings_.SetNumThreads( (unsigned int) num_threads );
+    }
+
+    // Energies //
+
+    else if( key == "energy" )
+    {
+        ExpectTokens( tokens, 3 );
+        double energy = ReadNumber( tokens[2] );
+        if( energy <= 0.0 )
+        {
+            Error( "energy '" + tokens[1] + "' must be positive" );
+        }
+        energies_[ tokens[1] ] = energy;
+    }
+
+    // Materials //
+
+    else if( key == "material" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( materials_.find( tokens[1] ) != materials_.end() )
+        {
+            Error( "material '" + tokens[1] + "' is already defined" );
+        }
+        materials_[ tokens[1] ] = Material();
+        cur_material_ = tokens[1];
+    }
+
+    // Layout //
+
+    else if( key == "segment" )
+    {
+        ExpectTokens( tokens, 6 );
+        auto material_it = materials_.find( tokens[1] );
+        if( material_it == materials_.end() )
+        {
+            Error( "unknown material '" + tokens[1] + "'" );
+        }
+        double width = ReadNumber( tokens[2] );
+        double num_cells = ReadNumber( tokens[3] );
+        if( width <= 0.0 || num_cells < 1.0 )
+        {
+            Error( "segment must have positive width and at least one cell" );
+        }
+        layout_.AddToEnd( material_it->second, width, (unsigned int) num_cells,
+                ReadNumber( tokens[4] ), ReadNumber( tokens[5] ) );
+    }
+
+    // Solve modes //
+
+    else if( key == "solve" )
+    {
+        ExpectTokens( tokens, 2 );
+        if( tokens[1] == "eigenvalue" )
+        {
+            solve_modes_.push_back( EIGENVALUE );
+        }
+        else if( tokens[1] == "adj_eigenvalue" )
+        {
+            solve_modes_.push_back( ADJ_EIGENVALUE );
+        }
+        else if( tokens[1] == "fused_eigenvalue" )
+        {
+            solve_modes_.push_back( FUSED_EIGENVALUE );
+        }
+        else if( tokens[1] == "concurrent_eigenvalue" )
+        {
+            solve_modes_.push_back( CONCURRENT_EIGENVALUE );
+        }
+        else if( tokens[1] == "fission_matrix" )
+        {
+            solve_modes_.push_back( FISSION_MATRIX );
+        }
+        else if( tokens[1] == "first_generation_weighted_source" )
+        {
+            solve_modes_.push_back( FIRST_GENERATION_WEIGHTED_SOURCE );
+        }
+        else if( tokens[1] == "fission_source" )
+        {
+            solve_modes_.push_back( FISSION_SOURCE );
+        }
+        else if( tokens[1] == "memory_report" )
+        {
+            solve_modes_.push_back( MEMORY_REPORT );
+        }
+        else if( tokens[1] == "precision_report" )
+        {
+            solve_modes_.push_back( PRECISION_REPORT );
+        }
+        else if( tokens[1] == "adaptive_eigenvalue" )
+        {
+            solve_modes_.push_back( ADAPTIVE_EIGENVALUE );
+        }
+        else if( tokens[1] == "mesh_sequenced_eigenvalue" )
+        {
+            solve_modes_.push_back( MESH_SEQUENCED_EIGENVALUE );
+        }
+        else if( tokens[1] == "jfnk_eigenvalue" )
+        {
+            solve_modes_.push_back( JFNK_EIGENVALUE );
+        }
+        else
+        {
+            Error( "unknown solve mode '" + tokens[1] + "'" );
+        }
+    }
+    else
+    {
+        Error( "unknown keyword '" + key + "'" );
+    }
+}
+
+// Parse a single tokenized line inside a material block
+void Deck::ParseMaterialLine( const std::vector<std::string> &tokens )
+{
+    const std::string &key = tokens.front();
+    Material &material = materials_[ cur_material_ ];
+
+    if( key == "end" )
+    {
+        ExpectTokens( tokens, 1 );
+        cur_material_.clear();
+    }
+    else if( key == "abs" )
+    {
+        ExpectTokens( tokens, 3 );
+        material.SetMacroAbsXsec( ReadEnergy( tokens[1] ), ReadNumber( tokens[2] ) );
+    }
+    else if( key == "scat" )
+    {
+        ExpectTokens( tokens, 4 );
+        double value = ReadNumber( tokens[3] );
+        if( value < 0.0 )
+        {
+            Error( "scattering cross section must be nonnegative" );
+        }
+        material.SetMacroScatXsec( ReadEnergy( tokens[1] ), ReadEnergy( tokens[2] ), value );
+    }
+    else if( key == "scat_moment" )
+    {
+        ExpectTokens( tokens, 5 );
+        double moment = ReadNumber( tokens[1] );
+        if( moment < 1.0 || std::fmod( moment, 1.0 ) != 0.0 )
+        {
+            Error( "scattering moment must be a positive integer" );
+        }
+        material.SetMacroScatMoment( (unsigned int) moment, ReadEnergy( tokens[2] ), ReadEnergy( tokens[3] ),
+                ReadNumber( tokens[4] ) );
+    }
+    else if( key == "fiss" )
+    {
+        ExpectTokens( tokens, 3 );
+        material.SetMacroFissXsec( ReadEnergy( tokens[1] ), ReadNumber( tokens[2] ) );
+    }
+    else if( key == "nu" )
+    {
+        ExpectTokens( tokens, 3 );
+        material.SetFissNu( ReadEnergy( tokens[1] ), ReadNumber( tokens[2] ) );
+    }
+    else if( key == "chi" )
+    {
+        ExpectTokens( tokens, 3 );
+        material.SetFissChi( ReadEnergy( tokens[1] ), ReadNumber( tokens[2] ) );
+    }
+    else if( key == "ext_source" )
+    {
+        ExpectTokens( tokens, 3 );
+        material.SetExtSource( ReadEnergy( tokens[1] ), ReadNumber( tokens[2] ) );
+    }
+    else if( key == "adj_ext_source" )
+    {
+        ExpectTokens( tokens, 3 );
+        material.AdjSetExtSource( ReadEnergy( tokens[1] ), ReadNumber( tokens[2] ) );
+    }
+    else
+    {
+        Error( "unknown material keyword '" + key + "'" );
+    }
+}
+
+// Convert token to a number
+double Deck::ReadNumber( const std::string &token ) const
+{
+    char *end = nullptr;
+    double value = std::strtod( token.c_str(), &end );
+    if( end == token.c_str() || *end != '\0' )
+    {
+        Error( "expected a number, found '" + token + "'" );
+    }
+    return value;
+}
+
+// Convert token to an energy, either a named energy or a number (eV)
+double Deck::ReadEnergy( const std::string &token ) const
+{
+    auto energy_it = energies_.find( token );
+    if( energy_it != energies_.end() )
+    {
+        return energy_it->second;
+    }
+    double energy = ReadNumber( token );
+    if( energy <= 0.0 )
+    {
+        Error( "energy must be positive, found '" + token + "'" );
+    }
+    return energy;
+}
+
+// Check number of tokens on current line
+void Deck::ExpectTokens( const std::vector<std::string> &tokens, unsigned int count ) const
+{
+    if( tokens.size() != count )
+    {
+        std::ostringstream message;
+        message << "'" << tokens.front() << "' expects " << count - 1 << " argument(s)";
+        Error( message.str() );
+    }
+}
+
+// Throw an error tagged with the current location in the deck
+void Deck::Error( const std::string &message ) const
+{
+    std::ostringstream full_message;
+    full_message << name_ << ":" << line_number_ << ": " << message;
+    throw std::runtime_error( full_message.str() );
+}
@@ -0,0 +1,98 @@
+// deck.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// biscotti includes
+#include "layout.hpp"
+#include "material.hpp"
+#include "settings.hpp"
+
+class Deck
+{
+    public:
+
+        // Enumerate solve modes
+        enum SolveMode
+        {
+            EIGENVALUE,
+            ADJ_EIGENVALUE,
+            FUSED_EIGENVALUE,
+            CONCURRENT_EIGENVALUE,
+            FISSION_MATRIX,
+            FIRST_GENERATION_WEIGHTED_SOURCE,
+            FISSION_SOURCE,
+            MEMORY_REPORT,
+            PRECISION_REPORT,
+            ADAPTIVE_EIGENVALUE,
+            MESH_SEQUENCED_EIGENVALUE,
+            JFNK_EIGENVALUE
+        };
+
+        // Parse constructor (name is used in error messages)
+        Deck( std::istream &in, const std::string &name );
+
+        // Construct a Slab and perform each requested solve in order
+        void Run() const;
+
+        // Accessors and mutators //
+
+        // Return const reference to settings
+        const Settings &SettingsReference() const { return settings_; };
+
+        // Return const reference to layout
+        const Layout &LayoutReference() const { return layout_; };
+
+        // Return requested solve modes
+        const std::vector<SolveMode> &SolveModes() const { return solve_modes_; };
+
+    private:
+
+        // Parse a single tokenized line
+        void ParseLine( const std::vector<std::string> &tokens );
+
+        // Parse a single tokenized line inside a material block
+        void ParseMaterialLine( const std::vector<std::string> &tokens );
+
+        // Convert token to a number
+        double ReadNumber( const std::string &token ) const;
+
+        // Convert token to an energy, either a named energy or a number (eV)
+        double ReadEnergy( const std::string &token ) const;
+
+        // Check number of tokens on current line
+        void ExpectTokens( const std::vector<std::string> &tokens, unsigned int count ) const;
+
+        // Throw an error tagged with the current location in the deck
+        void Error( const std::string &message ) const;
+
+        // Name of deck (usually a filename)
+        std::string name_;
+
+        // Current line number
+        unsigned int line_number_;
+
+        // Settings
+        Settings settings_;
+
+        // Named energies (eV)
+        std::map<std::string,double> energies_;
+
+        // Named materials
+        std::map<std::string,Material> materials_;
+
+        // Name of material currently being defined, empty if none
+        std::string cur_material_;
+
+        // Layout
+        Layout layout_;
+
+        // Requested solve modes, in order
+        std::vector<SolveMode> solve_modes_;
+};
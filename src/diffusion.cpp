@@ -0,0 +1,303 @@
+// diffusion.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+// biscotti includes
+#include "diffusion.hpp"
+#include "flatmaterial.hpp"
+#include "layout.hpp"
+#include "segment.hpp"
+#include "settings.hpp"
+#include "sweepkernel.hpp"
+
+namespace
+{
+
+// Iterations after which a diffusion solve gives up on convergence and hands
+// over what it has
+const unsigned int max_iterations = 10000;
+
+// Return current coupling coefficient of a vacuum boundary to the adjacent
+// cell (Marshak condition, the incoming partial current is zero)
+double VacuumCoupling( double diff_coef, double width )
+{
+    return 2.0 * diff_coef / ( width + 4.0 * diff_coef );
+}
+
+}
+
+// Set up the problem on the cells of a layout
+Diffusion::Diffusion( const Layout &layout, const Settings &settings ):
+    settings_( settings ),
+    num_groups_( layout.SegmentReference( 0 ).FlatMaterialReference().Energies().size() ),
+    k_( 0.0 ),
+    num_iterations_( 0 )
+{
+    for( unsigned int s = 0; s != layout.NumSegments(); s++ )
+    {
+        const Segment &segment = layout.SegmentReference( s );
+        for( int c = 0; c != segment.NumCells(); c++ )
+        {
+            materials_.push_back( &segment.FlatMaterialReference() );
+            widths_.push_back( segment.CellWidth() );
+        }
+    }
+
+    // coupling_ of each group couples cell i - 1 to cell i and, past the last
+    // cell, the last cell to the right boundary
+    const std::size_t num_cells = widths_.size();
+    coupling_.resize( num_groups_ * ( num_cells + 1 ) );
+    for( unsigned int g = 0; g != num_groups_; g++ )
+    {
+        double *coupling = &coupling_[ g * ( num_cells + 1 ) ];
+        for( std::size_t i = 0; i <= num_cells; i++ )
+        {
+            if( i == 0 || i == num_cells )
+            {
+                const Settings::BoundaryCondition bc = i == 0 ? settings_.LeftBC() : settings_.RightBC();
+                const std::size_t c = i == 0 ? 0 : num_cells - 1;
+                coupling[ i ] = bc == Settings::VACUUM ?
+                    VacuumCoupling( 1.0 / ( 3.0 * materials_[ c ]->TotMacroXsec()[ g ] ), widths_[ c ] ) : 0.0;
+            }
+            else
+            {
+                // Harmonic mean keeps the current continuous across a material
+                // interface
+                const double left = 1.0 / ( 3.0 * materials_[ i - 1 ]->TotMacroXsec()[ g ] );
+                const double right = 1.0 / ( 3.0 * materials_[ i ]->TotMacroXsec()[ g ] );
+                coupling[ i ] = 2.0 * left * right / ( left * widths_[ i ] + right * widths_[ i - 1 ] );
+            }
+        }
+    }
+    // Fixed source problems are solved for the flux at the cell edges
+    diag_.resize( num_cells + 1 );
+    rhs_.resize( num_cells + 1 );
+    scratch_.resize( num_cells + 1 );
+    source_.resize( num_cells * num_groups_ );
+    prev_scl_flux_.resize( num_cells * num_groups_ );
+    scl_flux_.resize( num_cells * num_groups_ );
+}
+
+// Solve for the k eigenvalue starting from k_guess and a flat flux
+template<Sense S>
+bool Diffusion::Solve( double k_guess )
+{
+    const std::size_t num_cells = widths_.size();
+    const unsigned int num_groups = num_groups_;
+    scl_flux_.assign( num_cells * num_groups, 1.0 );
+    k_ = k_guess;
+    double production = FissionProduction<S>();
+    if( !( production > 0.0 ) )
+    {
+        return false;
+    }
+
+    for( num_iterations_ = 1; num_iterations_ <= max_iterations; num_iterations_++ )
+    {
+        // Fission neutrons of the previous iterate, the adjoint swapping the
+        // roles of the production and emission spectra as in Cell
+        for( std::size_t i = 0; i != num_cells; i++ )
+        {
+            const std::vector<double> &spectrum = S == FORWARD ? materials_[ i ]->FissProduction() : materials_[ i ]->FissChi();
+            const std::vector<double> &emission = S == FORWARD ? materials_[ i ]->FissChi() : materials_[ i ]->FissProduction();
+            double rate = 0.0;
+            for( unsigned int g = 0; g != num_groups; g++ )
+            {
+                rate += spectrum[ g ] * scl_flux_[ i * num_groups + g ];
+            }
+            rate /= k_;
+            for( unsigned int g = 0; g != num_groups; g++ )
+            {
+                source_[ i * num_groups + g ] = emission[ g ] * rate;
+            }
+        }
+        prev_scl_flux_ = scl_flux_;
+        SolveGroups<S>( source_ );
+
+        const double prev_production = production;
+        const double prev_k = k_;
+        production = FissionProduction<S>();
+        k_ = prev_k * production / prev_production;
+        if( std::fabs( ( k_ - prev_k ) / prev_k ) < settings_.KTol() && MaxFluxChange() < settings_.SclFluxTol() )
+        {
+            break;
+        }
+    }
+    num_iterations_ = std::min( num_iterations_, max_iterations );
+
+    for( auto it = scl_flux_.begin(); it != scl_flux_.end(); it++ )
+    {
+        *it /= production;
+    }
+    return true;
+}
+
+// Solve the fixed source problem without fission starting from a zero flux
+template<Sense S>
+void Diffusion::SolveFixedSource( const std::vector<double> &source )
+{
+    scl_flux_.assign( widths_.size() * num_groups_, 0.0 );
+    // Without upscattering the second iteration only confirms the first
+    for( num_iterations_ = 1; num_iterations_ <= max_iterations; num_iterations_++ )
+    {
+        prev_scl_flux_ = scl_flux_;
+        SolveEdgeGroups<S>( source );
+        if( MaxFluxChange() < settings_.SclFluxTol() )
+        {
+            break;
+        }
+    }
+    num_iterations_ = std::min( num_iterations_, max_iterations );
+}
+
+// Solve each group's tridiagonal system in turn with the given source
+template<Sense S>
+void Diffusion::SolveGroups( const std::vector<double> &source )
+{
+    const std::size_t num_cells = widths_.size();
+    const unsigned int num_groups = num_groups_;
+    // Scattering from groups already solved is taken from this iteration.
+    // Forward neutrons mostly scatter down, adjoint importance up.
+    for( unsigned int n = 0; n != num_groups; n++ )
+    {
+        const unsigned int g = S == FORWARD ? num_groups - 1 - n : n;
+        const double *coupling = &coupling_[ g * ( num_cells + 1 ) ];
+        for( std::size_t i = 0; i != num_cells; i++ )
+        {
+            const FlatMaterial &material = *materials_[ i ];
+            const ScatteringKernel &kernel = S == FORWARD ? material.ScatKernel() : material.AdjScatKernel();
+            const double removal = material.TotMacroXsec()[ g ] - kernel.SelfScatter( g );
+            diag_[ i ] = coupling[ i ] + coupling[ i + 1 ] + removal * widths_[ i ];
+            rhs_[ i ] = ( kernel.InScatter( g, &scl_flux_[ i * num_groups ] ) + source[ i * num_groups + g ] ) *
+                widths_[ i ];
+        }
+
+        // Thomas algorithm, the off diagonal entries being -coupling
+        scratch_[ 0 ] = -coupling[ 1 ] / diag_[ 0 ];
+        rhs_[ 0 ] /= diag_[ 0 ];
+        for( std::size_t i = 1; i != num_cells; i++ )
+        {
+            const double pivot = diag_[ i ] + coupling[ i ] * scratch_[ i - 1 ];
+            scratch_[ i ] = -coupling[ i + 1 ] / pivot;
+            rhs_[ i ] = ( rhs_[ i ] + coupling[ i ] * rhs_[ i - 1 ] ) / pivot;
+        }
+        for( std::size_t i = num_cells - 1; i-- != 0; )
+        {
+            rhs_[ i ] -= scratch_[ i ] * rhs_[ i + 1 ];
+        }
+        for( std::size_t i = 0; i != num_cells; i++ )
+        {
+            scl_flux_[ i * num_groups + g ] = rhs_[ i ];
+        }
+    }
+}
+
+// Solve each group's tridiagonal system for the edge fluxes in turn with the
+// given source
+template<Sense S>
+void Diffusion::SolveEdgeGroups( const std::vector<double> &source )
+{
+    // Each cell couples its two edges through its leakage D / h and its removal
+    // split as diamond difference splits the cell flux, a quarter of sigma h
+    // per edge pair, and contributes half its source to each edge. Unlike a
+    // cell centered scheme this stays a stable correction of diamond
+    // difference sweeps on optically thick cells (Alcouffe's consistent
+    // diffusion synthetic acceleration).
+    const std::size_t num_cells = widths_.size();
+    const unsigned int num_groups = num_groups_;
+    for( unsigned int n = 0; n != num_groups; n++ )
+    {
+        const unsigned int g = S == FORWARD ? num_groups - 1 - n : n;
+        std::fill( diag_.begin(), diag_.end(), 0.0 );
+        std::fill( rhs_.begin(), rhs_.end(), 0.0 );
+        // The off diagonal entry between edges i and i + 1 is kept in
+        // scratch_[ i ] until elimination
+        for( std::size_t i = 0; i != num_cells; i++ )
+        {
+            const FlatMaterial &material = *materials_[ i ];
+            const ScatteringKernel &kernel = S == FORWARD ? material.ScatKernel() : material.AdjScatKernel();
+            const double leakage = 1.0 / ( 3.0 * material.TotMacroXsec()[ g ] * widths_[ i ] );
+            const double removal = 0.25 * ( material.TotMacroXsec()[ g ] - kernel.SelfScatter( g ) ) * widths_[ i ];
+            const double half_source = 0.5 * widths_[ i ] *
+                ( kernel.InScatter( g, &scl_flux_[ i * num_groups ] ) + source[ i * num_groups + g ] );
+            diag_[ i ] += leakage + removal;
+            diag_[ i + 1 ] += leakage + removal;
+            scratch_[ i ] = removal - leakage;
+            rhs_[ i ] += half_source;
+            rhs_[ i + 1 ] += half_source;
+        }
+        // A vacuum boundary loses half its edge flux (Marshak condition)
+        diag_[ 0 ] += settings_.LeftBC() == Settings::VACUUM ? 0.5 : 0.0;
+        diag_[ num_cells ] += settings_.RightBC() == Settings::VACUUM ? 0.5 : 0.0;
+
+        // Thomas algorithm on the symmetric system
+        rhs_[ 0 ] /= diag_[ 0 ];
+        double upper = scratch_[ 0 ] / diag_[ 0 ];
+        for( std::size_t i = 1; i <= num_cells; i++ )
+        {
+            const double lower = scratch_[ i - 1 ];
+            scratch_[ i - 1 ] = upper;
+            const double pivot = diag_[ i ] - lower * upper;
+            upper = i != num_cells ? scratch_[ i ] / pivot : 0.0;
+            rhs_[ i ] = ( rhs_[ i ] - lower * rhs_[ i - 1 ] ) / pivot;
+        }
+        for( std::size_t i = num_cells; i-- != 0; )
+        {
+            rhs_[ i ] -= scratch_[ i ] * rhs_[ i + 1 ];
+        }
+        for( std::size_t i = 0; i != num_cells; i++ )
+        {
+            scl_flux_[ i * num_groups + g ] = 0.5 * ( rhs_[ i ] + rhs_[ i + 1 ] );
+        }
+    }
+}
+
+// Return the largest flux change of the last iteration relative to the
+// largest flux of its group
+double Diffusion::MaxFluxChange() const
+{
+    double flux_error = 0.0;
+    for( unsigned int g = 0; g != num_groups_; g++ )
+    {
+        double max_flux = 0.0;
+        double max_change = 0.0;
+        for( std::size_t i = g; i < scl_flux_.size(); i += num_groups_ )
+        {
+            max_flux = std::max( max_flux, std::fabs( scl_flux_[ i ] ) );
+            max_change = std::max( max_change, std::fabs( scl_flux_[ i ] - prev_scl_flux_[ i ] ) );
+        }
+        flux_error = std::max( flux_error, max_flux > 0.0 ? max_change / max_flux : 0.0 );
+    }
+    return flux_error;
+}
+
+// Return fission neutron production of the scalar flux integrated over the
+// cells
+template<Sense S>
+double Diffusion::FissionProduction() const
+{
+    double production = 0.0;
+    for( std::size_t i = 0; i != widths_.size(); i++ )
+    {
+        const std::vector<double> &spectrum = S == FORWARD ? materials_[ i ]->FissProduction() : materials_[ i ]->FissChi();
+        double rate = 0.0;
+        for( unsigned int g = 0; g != num_groups_; g++ )
+        {
+            rate += spectrum[ g ] * scl_flux_[ i * num_groups_ + g ];
+        }
+        production += rate * widths_[ i ];
+    }
+    return production;
+}
+
+// Explicit instantiations //
+
+template bool Diffusion::Solve<FORWARD>( double k_guess );
+template bool Diffusion::Solve<ADJOINT>( double k_guess );
+template void Diffusion::SolveFixedSource<FORWARD>( const std::vector<double> &source );
+template void Diffusion::SolveFixedSource<ADJOINT>( const std::vector<double> &source );
@@ -0,0 +1,116 @@
+// diffusion.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <vector>
+
+// biscotti includes
+#include "flatmaterial.hpp"
+#include "layout.hpp"
+#include "settings.hpp"
+#include "sweepkernel.hpp"
+
+// Multigroup finite difference diffusion k eigenvalue problem on the cells of a
+// layout, used as a cheap initial guess for transport, and the fixed source
+// problem of the scalar flux error left by a sweep. Each cell has the
+// diffusion coefficient 1 / ( 3 sigma_t ) of its material; cells are coupled
+// through their harmonic mean and vacuum boundaries use the Marshak condition.
+// Power iterations solve each group's tridiagonal system in turn, fastest group
+// first for the forward problem and slowest first for the adjoint.
+class Diffusion
+{
+    public:
+
+        // Set up the problem on the cells of a layout with the boundary
+        // conditions and tolerances of settings. The layout must outlive it.
+        Diffusion( const Layout &layout, const Settings &settings );
+
+        // Solve for the k eigenvalue starting from k_guess and a flat flux.
+        // Return false if the layout produces no fission source.
+        template<Sense S>
+        bool Solve( double k_guess );
+
+        // Solve the fixed source problem with the given isotropic source of
+        // each cell, slowest group first, and no fission, starting from a zero
+        // flux. It is discretized on the cell edges, consistently with diamond
+        // difference, and does not allocate once the flux is sized.
+        template<Sense S>
+        void SolveFixedSource( const std::vector<double> &source );
+
+        // Accessors and mutators //
+
+        // Return k eigenvalue
+        double KEigenvalue() const { return k_; };
+
+        // Return scalar flux of each cell, slowest group first. An eigenvalue
+        // solution is normalized to a total fission neutron production of one.
+        const std::vector<double> &ScalarFlux() const { return scl_flux_; };
+
+        // Return number of iterations performed by the last solve
+        unsigned int NumIterations() const { return num_iterations_; };
+
+    private:
+
+        // Solve each group's tridiagonal system in turn with the given
+        // isotropic source of each cell, scattering from the other groups taken
+        // from the current flux
+        template<Sense S>
+        void SolveGroups( const std::vector<double> &source );
+
+        // Solve each group's tridiagonal system for the edge fluxes in turn
+        // with the given isotropic source of each cell, scattering from the
+        // other groups taken from the current cell fluxes, and set the cell
+        // fluxes to the mean of their edges
+        template<Sense S>
+        void SolveEdgeGroups( const std::vector<double> &source );
+
+        // Return the largest flux change of the last iteration relative to the
+        // largest flux of its group
+        double MaxFluxChange() const;
+
+        // Return fission neutron production of the scalar flux integrated over
+        // the cells
+        template<Sense S>
+        double FissionProduction() const;
+
+        // Const Settings
+        const Settings settings_;
+
+        // Number of energy groups
+        unsigned int num_groups_;
+
+        // Material of each cell
+        std::vector<const FlatMaterial *> materials_;
+
+        // Width of each cell
+        std::vector<double> widths_;
+
+        // Coupling coefficient of each face of each group: cell i - 1 to cell i,
+        // and the last cell to the right boundary at index of the number of
+        // cells
+        std::vector<double> coupling_;
+
+        // Diagonal, right hand side and elimination scratch of the tridiagonal
+        // system of one group, sized for the cell edges
+        std::vector<double> diag_;
+        std::vector<double> rhs_;
+        std::vector<double> scratch_;
+
+        // Fission source of each cell of an eigenvalue iteration, slowest
+        // group first
+        std::vector<double> source_;
+
+        // Scalar flux of the previous iteration
+        std::vector<double> prev_scl_flux_;
+
+        // Scalar flux of each cell, slowest group first
+        std::vector<double> scl_flux_;
+
+        // k eigenvalue
+        double k_;
+
+        // Number of iterations performed by the last solve
+        unsigned int num_iterations_;
+};
@@ -0,0 +1,60 @@
+// flatmaterial.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// biscotti includes
+#include "flatmaterial.hpp"
+#include "groupdependent.hpp"
+#include "material.hpp"
+#include "scatteringkernel.hpp"
+
+// Flatten material
+FlatMaterial::FlatMaterial( const Material &material ):
+    material_( material ),
+    scat_kernel_( material_.MacroScatXsec(), material_.TotMacroXsec() ),
+    adj_scat_kernel_( material_.AdjMacroScatXsec(), material_.TotMacroXsec() )
+{
+    // Energy groups are those the total cross section is defined on
+    const GroupDependent &tot_macro_xsec = material_.TotMacroXsec();
+    for( auto it = tot_macro_xsec.slowest(); it != std::next( tot_macro_xsec.fastest() ); it++ )
+    {
+        energies_.push_back( it->first );
+        tot_macro_xsec_.push_back( it->second );
+        fiss_production_.push_back( material_.FissNu().at( it->first ) * material_.MacroFissXsec().at( it->first ) );
+        fiss_chi_.push_back( material_.FissChi().at( it->first ) );
+        ext_source_.push_back( material_.ExtSource().at( it->first ) );
+        adj_ext_source_.push_back( material_.AdjExtSource().at( it->first ) );
+    }
+    for( unsigned int l = 1; l <= material_.ScatOrder(); l++ )
+    {
+        scat_moment_kernels_.push_back( ScatteringKernel( material_.MacroScatMoment( l ), tot_macro_xsec ) );
+        adj_scat_moment_kernels_.push_back( ScatteringKernel( material_.AdjMacroScatMoment( l ), tot_macro_xsec ) );
+    }
+}
+
+// Return memory used by flattened data (bytes)
+std::size_t FlatMaterial::MemoryUsage() const
+{
+    // The maps of the original material are not counted
+    std::size_t bytes = sizeof( FlatMaterial ) + sizeof( double ) * ( energies_.capacity() + tot_macro_xsec_.capacity() +
+            fiss_production_.capacity() + fiss_chi_.capacity() + ext_source_.capacity() + adj_ext_source_.capacity() ) +
+        scat_kernel_.MemoryUsage() + adj_scat_kernel_.MemoryUsage();
+    for( unsigned int l = 1; l <= ScatOrder(); l++ )
+    {
+        bytes += sizeof( ScatteringKernel ) * 2 + ScatMomentKernel( l ).MemoryUsage() + AdjScatMomentKernel( l ).MemoryUsage();
+    }
+    return bytes;
+}
+
+// Friend functions //
+
+// Overload operator<<()
+std::ostream &operator<< ( std::ostream &out, const FlatMaterial &obj )
+{
+    out << obj.material_;
+    return out;
+}
@@ -0,0 +1,114 @@
+// flatmaterial.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// biscotti includes
+#include "material.hpp"
+#include "scatteringkernel.hpp"
+
+// Material data in the form used by the transport kernels: group values are
+// flattened into vectors, slowest group first, and scattering cross sections
+// are compressed. Built once per distinct material and shared by every segment
+// made of it.
+class FlatMaterial
+{
+    public:
+
+        // Flatten material
+        explicit FlatMaterial( const Material &material );
+
+        // Return memory used by flattened data (bytes)
+        std::size_t MemoryUsage() const;
+
+        // Accessors and mutators //
+
+        // Return const reference to material
+        const Material &MaterialReference() const { return material_; };
+
+        // Energy groups (eV)
+        const std::vector<double> &Energies() const { return energies_; };
+
+        // Macroscopic total cross section
+        const std::vector<double> &TotMacroXsec() const { return tot_macro_xsec_; };
+
+        // Fission neutron production, nu times macroscopic fission cross section
+        const std::vector<double> &FissProduction() const { return fiss_production_; };
+
+        // Distribution of prompt fission neutrons, chi
+        const std::vector<double> &FissChi() const { return fiss_chi_; };
+
+        // External source
+        const std::vector<double> &ExtSource() const { return ext_source_; };
+
+        // [Adjoint] External source
+        const std::vector<double> &AdjExtSource() const { return adj_ext_source_; };
+
+        // Compressed scattering cross sections
+        const ScatteringKernel &ScatKernel() const { return scat_kernel_; };
+
+        // [Adjoint] Compressed scattering cross sections
+        const ScatteringKernel &AdjScatKernel() const { return adj_scat_kernel_; };
+
+        // Number of Legendre moments of the scattering cross sections above P0
+        unsigned int ScatOrder() const { return scat_moment_kernels_.size(); };
+
+        // Compressed Legendre moment 1 <= l <= ScatOrder() of the scattering
+        // cross sections
+        const ScatteringKernel &ScatMomentKernel( unsigned int moment ) const { return scat_moment_kernels_[ moment - 1 ]; };
+
+        // [Adjoint] Compressed Legendre moment 1 <= l <= ScatOrder() of the
+        // scattering cross sections
+        const ScatteringKernel &AdjScatMomentKernel( unsigned int moment ) const { return adj_scat_moment_kernels_[ moment - 1 ]; };
+
+        // Friend functions //
+
+        // Overload operator<<()
+        friend std::ostream &operator<< ( std::ostream &out, const FlatMaterial &obj );
+
+    private:
+
+        // Material
+        const Material material_;
+
+        // Energy groups (eV)
+        std::vector<double> energies_;
+
+        // Macroscopic total cross section
+        std::vector<double> tot_macro_xsec_;
+
+        // Fission neutron production, nu times macroscopic fission cross section
+        std::vector<double> fiss_production_;
+
+        // Distribution of prompt fission neutrons, chi
+        std::vector<double> fiss_chi_;
+
+        // External source
+        std::vector<double> ext_source_;
+
+        // [Adjoint] External source
+        std::vector<double> adj_ext_source_;
+
+        // Compressed scattering cross sections
+        const ScatteringKernel scat_kernel_;
+
+        // [Adjoint] Compressed scattering cross sections
+        const ScatteringKernel adj_scat_kernel_;
+
+        // Compressed Legendre moments of the scattering cross sections above P0
+        std::vector<ScatteringKernel> scat_moment_kernels_;
+
+        // [Adjoint] Compressed Legendre moments of the scattering cross
+        // sections above P0
+        std::vector<ScatteringKernel> adj_scat_moment_kernels_;
+};
+
+// Friend functions //
+
+// Overload operator<<()
+std::ostream &operator<< ( std::ostream &out, const FlatMaterial &obj );
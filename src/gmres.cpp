@@ -0,0 +1,142 @@
+// gmres.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// biscotti includes
+#include "gmres.hpp"
+
+// Solve systems of size unknowns in at most max_size iterations
+Gmres::Gmres( std::size_t size, unsigned int max_size ):
+    size_( size ),
+    max_size_( max_size ),
+    num_iterations_( 0 ),
+    b_norm_( 0.0 ),
+    residual_norm_( 0.0 ),
+    target_norm_( 0.0 ),
+    basis_( max_size + 1, std::vector<double>( size ) ),
+    hessenberg_( ( max_size + 1 ) * max_size ),
+    cosines_( max_size ),
+    sines_( max_size ),
+    rotated_( max_size + 1 ),
+    coefficients_( max_size )
+{}
+
+// Start solving A x = b
+void Gmres::Start( const std::vector<double> &b, double tolerance )
+{
+    num_iterations_ = 0;
+    double sum = 0.0;
+    for( std::size_t i = 0; i != size_; i++ )
+    {
+        sum += b[ i ] * b[ i ];
+    }
+    b_norm_ = std::sqrt( sum );
+    residual_norm_ = b_norm_;
+    target_norm_ = tolerance * b_norm_;
+    std::fill( rotated_.begin(), rotated_.end(), 0.0 );
+    rotated_[ 0 ] = b_norm_;
+    std::vector<double> &direction = basis_[ 0 ];
+    for( std::size_t i = 0; i != size_; i++ )
+    {
+        direction[ i ] = b_norm_ > 0.0 ? b[ i ] / b_norm_ : 0.0;
+    }
+}
+
+// Return true while the residual is above tolerance and the subspace not full
+bool Gmres::Continue() const
+{
+    return residual_norm_ > target_norm_ && num_iterations_ != max_size_;
+}
+
+// Extend the Krylov subspace with the product of A and Direction()
+void Gmres::Extend( const std::vector<double> &product )
+{
+    // Orthogonalize the product against the basis by modified Gram-Schmidt
+    const unsigned int j = num_iterations_;
+    const std::size_t rows = max_size_ + 1;
+    double *column = &hessenberg_[ j * rows ];
+    std::vector<double> &next = basis_[ j + 1 ];
+    std::copy( product.begin(), product.end(), next.begin() );
+    for( unsigned int i = 0; i <= j; i++ )
+    {
+        const std::vector<double> &vector = basis_[ i ];
+        double dot = 0.0;
+        for( std::size_t n = 0; n != size_; n++ )
+        {
+            dot += next[ n ] * vector[ n ];
+        }
+        for( std::size_t n = 0; n != size_; n++ )
+        {
+            next[ n ] -= dot * vector[ n ];
+        }
+        column[ i ] = dot;
+    }
+    double sum = 0.0;
+    for( std::size_t n = 0; n != size_; n++ )
+    {
+        sum += next[ n ] * next[ n ];
+    }
+    const double norm = std::sqrt( sum );
+    column[ j + 1 ] = norm;
+    // A zero norm means the subspace holds the solution, and the next
+    // direction is never used
+    for( std::size_t n = 0; n != size_ && norm > 0.0; n++ )
+    {
+        next[ n ] /= norm;
+    }
+
+    // Reduce the new column to upper triangular with the previous rotations
+    // and one more, which also rotates the norm of b
+    for( unsigned int i = 0; i != j; i++ )
+    {
+        const double upper = column[ i ];
+        const double lower = column[ i + 1 ];
+        column[ i ] = cosines_[ i ] * upper + sines_[ i ] * lower;
+        column[ i + 1 ] = -sines_[ i ] * upper + cosines_[ i ] * lower;
+    }
+    const double radius = std::hypot( column[ j ], column[ j + 1 ] );
+    cosines_[ j ] = radius > 0.0 ? column[ j ] / radius : 1.0;
+    sines_[ j ] = radius > 0.0 ? column[ j + 1 ] / radius : 0.0;
+    column[ j ] = radius;
+    column[ j + 1 ] = 0.0;
+    rotated_[ j + 1 ] = -sines_[ j ] * rotated_[ j ];
+    rotated_[ j ] = cosines_[ j ] * rotated_[ j ];
+    residual_norm_ = std::fabs( rotated_[ j + 1 ] );
+    num_iterations_++;
+    if( norm == 0.0 )
+    {
+        residual_norm_ = 0.0;
+    }
+}
+
+// Write the x of the Krylov subspace with the smallest residual to x
+void Gmres::Solution( std::vector<double> &x )
+{
+    // Back substitute the rotated norm of b for the coefficients of the basis
+    // vectors
+    const std::size_t rows = max_size_ + 1;
+    const unsigned int m = num_iterations_;
+    for( unsigned int i = m; i-- != 0; )
+    {
+        double value = rotated_[ i ];
+        for( unsigned int j = i + 1; j != m; j++ )
+        {
+            value -= hessenberg_[ j * rows + i ] * coefficients_[ j ];
+        }
+        const double diagonal = hessenberg_[ i * rows + i ];
+        coefficients_[ i ] = diagonal != 0.0 ? value / diagonal : 0.0;
+    }
+    std::fill( x.begin(), x.end(), 0.0 );
+    for( unsigned int j = 0; j != m; j++ )
+    {
+        const std::vector<double> &vector = basis_[ j ];
+        for( std::size_t n = 0; n != size_; n++ )
+        {
+            x[ n ] += coefficients_[ j ] * vector[ n ];
+        }
+    }
+}
@@ -0,0 +1,81 @@
+// gmres.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <cstddef>
+#include <vector>
+
+// GMRES solution of a linear system A x = b from x = 0, without restarts. The
+// caller applies A, so that it need not be stored: while Continue() is true,
+// the product of A and Direction() is passed to Extend(). The Krylov basis and
+// the Hessenberg matrix are allocated up front for at most max_size
+// iterations, so that solving does not allocate.
+class Gmres
+{
+    public:
+
+        // Solve systems of size unknowns in at most max_size iterations
+        Gmres( std::size_t size, unsigned int max_size );
+
+        // Start solving A x = b to a residual norm of tolerance times that of
+        // b
+        void Start( const std::vector<double> &b, double tolerance );
+
+        // Return true while the residual is above tolerance and the Krylov
+        // subspace is not full
+        bool Continue() const;
+
+        // Extend the Krylov subspace with the product of A and Direction()
+        void Extend( const std::vector<double> &product );
+
+        // Write the x of the Krylov subspace with the smallest residual to x
+        void Solution( std::vector<double> &x );
+
+        // Accessors and mutators //
+
+        // Return vector A is to be applied to next
+        const std::vector<double> &Direction() const { return basis_[ num_iterations_ ]; };
+
+        // Return number of iterations performed since the start
+        unsigned int NumIterations() const { return num_iterations_; };
+
+        // Return residual norm of the current solution relative to that of b
+        double RelativeResidual() const { return b_norm_ > 0.0 ? residual_norm_ / b_norm_ : 0.0; };
+
+    private:
+
+        // Number of unknowns
+        std::size_t size_;
+
+        // Maximum number of iterations
+        unsigned int max_size_;
+
+        // Number of iterations performed since the start
+        unsigned int num_iterations_;
+
+        // Norm of b, residual norm of the current solution and the residual
+        // norm to reach
+        double b_norm_;
+        double residual_norm_;
+        double target_norm_;
+
+        // Orthonormal basis of the Krylov subspace, one vector beyond the
+        // iterations performed
+        std::vector<std::vector<double>> basis_;
+
+        // Hessenberg matrix of the iterations, column by column with
+        // max_size + 1 rows, reduced to upper triangular by Givens rotations
+        std::vector<double> hessenberg_;
+
+        // Cosines and sines of the Givens rotations
+        std::vector<double> cosines_;
+        std::vector<double> sines_;
+
+        // Norm of b rotated by the Givens rotations
+        std::vector<double> rotated_;
+
+        // Coefficients of the solution in the basis
+        std::vector<double> coefficients_;
+};
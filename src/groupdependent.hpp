@@ -74,6 +74,9 @@ class GroupDependent
             // Overload operator<<()
             friend std::ostream &operator<< ( std::ostream &out, const GroupDependent &obj );
 
+            // Overload operator==()
+            friend bool operator== ( const GroupDependent &u, const GroupDependent &v ) { return u.data_ == v.data_; };
+
             // Overload operator*() (vector scalar product)
             friend GroupDependent operator* ( const GroupDependent &g, const double &d );
 
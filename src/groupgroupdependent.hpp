@@ -39,6 +39,9 @@ class GroupGroupDependent
             // Overload operator<<()
             friend std::ostream &operator<< ( std::ostream &out, const GroupGroupDependent &obj );
 
+            // Overload operator==()
+            friend bool operator== ( const GroupGroupDependent &a, const GroupGroupDependent &b ) { return a.data_ == b.data_; };
+
             // Overload operator*() (matrix-vector multiplication)
             friend GroupDependent operator* ( const GroupGroupDependent &m, const GroupDependent &v );
 
@@ -4,14 +4,20 @@
 // std includes
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
+#include <memory>
 #include <set>
 #include <vector>
 
 // biscotti includes
 #include "cell.hpp"
+#include "flatmaterial.hpp"
 #include "layout.hpp"
+#include "quadrature.hpp"
 #include "segment.hpp"
+#include "settings.hpp"
+#include "sweepkernel.hpp"
 
 // Default constructor
 Layout::Layout()
@@ -21,25 +27,149 @@ Layout::Layout()
 void Layout::AddToEnd( Material material, double width, unsigned int num_cells, double scl_flux_guess, double adj_scl_flux_guess )
 {
     assert( num_cells > 0 );
-    data_.push_back( Segment( material, width, num_cells, scl_flux_guess, adj_scl_flux_guess ) );
+    // Segments of identical materials share one flattened material
+    std::shared_ptr<const FlatMaterial> flat_material;
+    for( auto segment_it = data_.begin(); segment_it != data_.end() && !flat_material; segment_it++ )
+    {
+        if( segment_it->MaterialReference() == material )
+        {
+            flat_material = segment_it->FlatMaterialPointer();
+        }
+    }
+    if( !flat_material )
+    {
+        flat_material = std::make_shared<const FlatMaterial>( material );
+    }
+    data_.push_back( Segment( flat_material, width, num_cells, scl_flux_guess, adj_scl_flux_guess ) );
+}
+
+// Add segment to end sharing the material and scalar flux guesses of an
+// existing segment
+void Layout::AddToEnd( const Segment &segment, double width, unsigned int num_cells )
+{
+    assert( num_cells > 0 );
+    data_.push_back( Segment( segment.FlatMaterialPointer(), width, num_cells, segment.ScalarFluxGuess(),
+                segment.AdjScalarFluxGuess() ) );
 }
 
 // Generate cells for use with Slab object
-std::vector<Cell> Layout::GenerateCells( const Settings &settings, const double &k, const double &adj_k ) const
+std::vector<Cell> Layout::GenerateCells( const Settings &settings ) const
 {
     assert( !data_.empty() );
+    const Quadrature &quadrature = Quadrature::GaussLegendre( settings.QuadratureOrder() );
     std::vector<Cell> output;
+    output.reserve( NumCells() );
     // Iterate through each segment in layout
     for( auto segment_it = data_.begin(); segment_it != data_.end(); segment_it++ )
     {
+        // Step characteristic coefficients depend only on the cell width,
+        // material and quadrature, so the cells of a segment share them
+        std::shared_ptr<const std::vector<double>> characteristic;
+        if( settings.SpatialScheme() == Settings::STEP_CHARACTERISTIC )
+        {
+            characteristic = std::make_shared<const std::vector<double>>( StepCharacteristicCoefficients(
+                        segment_it->CellWidth(), segment_it->FlatMaterialReference().TotMacroXsec(),
+                        quadrature.InverseAbsOrdinates() ) );
+        }
         for( int i = 0; i != segment_it->NumCells(); i++ )
         {
-            output.push_back( Cell( settings, *segment_it, k, adj_k ) );
+            output.push_back( Cell( *segment_it, quadrature, settings, characteristic ) );
         }
     }
     return output;
 }
 
+// Return true if the layout is its own mirror image and its midplane falls on a
+// cell boundary
+bool Layout::IsMirrorSymmetric() const
+{
+    const std::size_t num_segments = data_.size();
+    for( std::size_t i = 0; i < num_segments / 2; i++ )
+    {
+        const Segment &left = data_[ i ];
+        const Segment &right = data_[ num_segments - 1 - i ];
+        // Segments of identical materials share one flattened material
+        if( left.FlatMaterialPointer() != right.FlatMaterialPointer() || left.Width() != right.Width() ||
+                left.NumCells() != right.NumCells() || left.ScalarFluxGuess() != right.ScalarFluxGuess() ||
+                left.AdjScalarFluxGuess() != right.AdjScalarFluxGuess() )
+        {
+            return false;
+        }
+    }
+    // A middle segment is split between its cells
+    return num_segments % 2 == 0 || data_[ num_segments / 2 ].NumCells() % 2 == 0;
+}
+
+// Return the left half of a mirror symmetric layout
+Layout Layout::LeftHalf() const
+{
+    assert( IsMirrorSymmetric() );
+    const std::size_t num_segments = data_.size();
+    Layout half;
+    for( std::size_t i = 0; i < num_segments / 2; i++ )
+    {
+        half.data_.push_back( data_[ i ] );
+    }
+    if( num_segments % 2 != 0 )
+    {
+        const Segment &middle = data_[ num_segments / 2 ];
+        half.AddToEnd( middle, 0.5 * middle.Width(), middle.NumCells() / 2 );
+    }
+    return half;
+}
+
+// Return total number of cells
+unsigned int Layout::NumCells() const
+{
+    unsigned int num_cells = 0;
+    for( auto segment_it = data_.begin(); segment_it != data_.end(); segment_it++ )
+    {
+        num_cells += segment_it->NumCells();
+    }
+    return num_cells;
+}
+
+// Return cell widths, left to right
+std::vector<double> Layout::CellWidths() const
+{
+    std::vector<double> widths;
+    widths.reserve( NumCells() );
+    for( auto segment_it = data_.begin(); segment_it != data_.end(); segment_it++ )
+    {
+        widths.insert( widths.end(), segment_it->NumCells(), segment_it->CellWidth() );
+    }
+    return widths;
+}
+
+// Return layout with the cells of each segment merged factor at a time
+Layout Layout::Coarsened( unsigned int factor ) const
+{
+    assert( factor > 0 );
+    Layout coarse;
+    for( auto segment_it = data_.begin(); segment_it != data_.end(); segment_it++ )
+    {
+        const unsigned int num_cells = ( segment_it->NumCells() + factor - 1 ) / factor;
+        coarse.AddToEnd( *segment_it, segment_it->Width(), num_cells );
+    }
+    return coarse;
+}
+
+// Return memory used by flattened materials (bytes), counting each shared
+// material once
+std::size_t Layout::MaterialMemoryUsage() const
+{
+    std::set<const FlatMaterial *> materials;
+    std::size_t bytes = 0;
+    for( auto segment_it = data_.begin(); segment_it != data_.end(); segment_it++ )
+    {
+        if( materials.insert( &segment_it->FlatMaterialReference() ).second )
+        {
+            bytes += segment_it->FlatMaterialReference().MemoryUsage();
+        }
+    }
+    return bytes;
+}
+
 // Generate energy groups to use in calculation
 std::set<double> Layout::GenerateEnergyGroups() const
 {
@@ -4,6 +4,7 @@
 #pragma once
 
 // std includes
+#include <cstddef>
 #include <iostream>
 #include <set>
 #include <vector>
@@ -23,8 +24,41 @@ class Layout
         // Add segment to end
         void AddToEnd( Material material, double width, unsigned int num_cells, double scl_flux_guess, double adj_scl_flux_guess );
 
+        // Add segment to end sharing the material and scalar flux guesses of
+        // an existing segment
+        void AddToEnd( const Segment &segment, double width, unsigned int num_cells );
+
         // Generate cells for use with Slab object
-        std::vector<Cell> GenerateCells( const Settings &settings, const double &k, const double &adj_k ) const;
+        std::vector<Cell> GenerateCells( const Settings &settings ) const;
+
+        // Return number of segments
+        unsigned int NumSegments() const { return data_.size(); };
+
+        // Return const reference to segment at index
+        const Segment &SegmentReference( unsigned int index ) const { return data_[ index ]; };
+
+        // Return total number of cells
+        unsigned int NumCells() const;
+
+        // Return cell widths, left to right
+        std::vector<double> CellWidths() const;
+
+        // Return layout with the cells of each segment merged factor at a
+        // time, keeping at least one cell per segment
+        Layout Coarsened( unsigned int factor ) const;
+
+        // Return true if the layout is its own mirror image (materials,
+        // widths, cell counts and guesses of its segments) and its midplane
+        // falls on a cell boundary
+        bool IsMirrorSymmetric() const;
+
+        // Return the left half of a mirror symmetric layout, splitting the
+        // middle segment if there is one
+        Layout LeftHalf() const;
+
+        // Return memory used by flattened materials (bytes), counting each
+        // shared material once
+        std::size_t MaterialMemoryUsage() const;
 
         // Generate energy groups to use in calculation
         std::set<double> GenerateEnergyGroups() const;
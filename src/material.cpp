@@ -2,6 +2,7 @@
 // Aaron G. Tumulak
 
 // std includes
+#include <cassert>
 #include <iostream>
 
 // biscotti includes
@@ -28,6 +29,22 @@ void Material::SetMacroScatXsec( double from_energy, double to_energy, double va
     tot_macro_xsec_.Add( from_energy, value );
 }
 
+// Legendre moment of scattering cross section. Higher moments do not add to the
+// total cross section, but their groups are registered with it.
+void Material::SetMacroScatMoment( unsigned int moment, double from_energy, double to_energy, double value )
+{
+    assert( moment > 0 );
+    if( macro_scat_moments_.size() < moment )
+    {
+        macro_scat_moments_.resize( moment );
+        adj_macro_scat_moments_.resize( moment );
+    }
+    macro_scat_moments_[ moment - 1 ].Set( from_energy, to_energy, value );
+    adj_macro_scat_moments_[ moment - 1 ].Set( to_energy, from_energy, value );
+    tot_macro_xsec_.Add( from_energy, 0.0 );
+    tot_macro_xsec_.Add( to_energy, 0.0 );
+}
+
 // Fission cross section
 void Material::SetMacroFissXsec( double energy, double value )
 {
@@ -68,6 +85,10 @@ std::ostream &operator<< ( std::ostream &out, const Material &obj )
 
     out << "Macroscopic absorption cross section: \n" << obj.macro_abs_xsec_ << std::endl;
     out << "Macroscopic scattering cross sections: \n" << obj.macro_scat_xsec_ << std::endl;
+    for( unsigned int l = 1; l <= obj.ScatOrder(); l++ )
+    {
+        out << "Macroscopic scattering cross sections, moment " << l << ": \n" << obj.MacroScatMoment( l ) << std::endl;
+    }
     out << "Macroscopic fission cross section: \n" << obj.macro_fiss_xsec_ << std::endl;
     out << "Macroscopic total cross section: \n" << obj.tot_macro_xsec_ << std::endl;
     out << "Average number of neutrons per fission, nu: " << obj.fiss_nu_ << "\n" << std::endl;
@@ -78,3 +99,19 @@ std::ostream &operator<< ( std::ostream &out, const Material &obj )
 
     return out;
 }
+
+// Overload operator==()
+bool operator== ( const Material &a, const Material &b )
+{
+    return a.tot_macro_xsec_ == b.tot_macro_xsec_ &&
+        a.macro_abs_xsec_ == b.macro_abs_xsec_ &&
+        a.macro_scat_xsec_ == b.macro_scat_xsec_ &&
+        a.adj_macro_scat_xsec_ == b.adj_macro_scat_xsec_ &&
+        a.macro_scat_moments_ == b.macro_scat_moments_ &&
+        a.adj_macro_scat_moments_ == b.adj_macro_scat_moments_ &&
+        a.macro_fiss_xsec_ == b.macro_fiss_xsec_ &&
+        a.fiss_nu_ == b.fiss_nu_ &&
+        a.fiss_chi_ == b.fiss_chi_ &&
+        a.ext_source_ == b.ext_source_ &&
+        a.adj_ext_source_ == b.adj_ext_source_;
+}
@@ -5,6 +5,7 @@
 
 // std includes
 #include <iostream>
+#include <vector>
 
 // biscotti includes
 #include "groupdependent.hpp"
@@ -25,6 +26,14 @@ class Material
         const GroupGroupDependent &MacroScatXsec() const { return macro_scat_xsec_; };
         const GroupGroupDependent &AdjMacroScatXsec() const { return adj_macro_scat_xsec_; };
 
+        // Legendre moments of the scattering cross section above P0. Moment l
+        // scatters ( 2 l + 1 ) / 2 sigma_l phi_l P_l(mu) into each ordinate,
+        // phi_l being the flux moment l; the P0 moment is MacroScatXsec().
+        void SetMacroScatMoment( unsigned int moment, double from_energy, double to_energy, double value );
+        unsigned int ScatOrder() const { return macro_scat_moments_.size(); };
+        const GroupGroupDependent &MacroScatMoment( unsigned int moment ) const { return macro_scat_moments_[ moment - 1 ]; };
+        const GroupGroupDependent &AdjMacroScatMoment( unsigned int moment ) const { return adj_macro_scat_moments_[ moment - 1 ]; };
+
         void SetMacroFissXsec( double energy, double value );
         const GroupDependent &MacroFissXsec() const { return macro_fiss_xsec_; };
 
@@ -47,6 +56,9 @@ class Material
         // Overload operator<<()
         friend std::ostream &operator<< ( std::ostream &out, const Material &obj );
 
+        // Overload operator==()
+        friend bool operator== ( const Material &a, const Material &b );
+
     private:
 
         // Macroscopic total cross section
@@ -61,6 +73,14 @@ class Material
         // [Adjoint] Macroscopic scattering cross section
         GroupGroupDependent adj_macro_scat_xsec_;
 
+        // Legendre moments 1 through ScatOrder() of the macroscopic scattering
+        // cross section
+        std::vector<GroupGroupDependent> macro_scat_moments_;
+
+        // [Adjoint] Legendre moments 1 through ScatOrder() of the macroscopic
+        // scattering cross section
+        std::vector<GroupGroupDependent> adj_macro_scat_moments_;
+
         // Macroscopic fission cross section
         GroupDependent macro_fiss_xsec_;
 
@@ -81,3 +101,6 @@ class Material
 
 // Overload operator<<()
 std::ostream &operator<< ( std::ostream &out, const Material &obj );
+
+// Overload operator==()
+bool operator== ( const Material &a, const Material &b );
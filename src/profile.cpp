@@ -0,0 +1,119 @@
+// profile.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// biscotti includes
+#include "profile.hpp"
+
+#ifndef BISCOTTI_NO_PROFILE
+
+namespace
+{
+
+// Names of phases as printed
+const char *phase_names[ Profile::NUM_PHASES ] =
+{
+    "scatter_source",
+    "fission_source",
+    "sweep",
+    "acceleration",
+    "k_convergence",
+    "scalar_flux_convergence",
+    "output"
+};
+
+#ifdef BISCOTTI_COUNT_ALLOCATIONS
+const bool count_allocations = true;
+#else
+const bool count_allocations = false;
+#endif
+
+// Print one row of the summary table
+void PrintRow( std::ostream &out, const std::string &name, double seconds, double total, unsigned long calls,
+        unsigned long allocations )
+{
+    out << "  " << std::left << std::setw( 26 ) << name << std::right;
+    out << std::fixed << std::setprecision( 6 ) << std::setw( 12 ) << seconds;
+    out << std::setprecision( 1 ) << std::setw( 8 ) << ( total > 0.0 ? 100.0 * seconds / total : 0.0 ) << " %";
+    out << std::setw( 12 ) << calls;
+    if( count_allocations )
+    {
+        out << std::setw( 14 ) << allocations;
+        out << std::setprecision( 2 ) << std::setw( 14 ) << ( calls > 0 ? double( allocations ) / calls : 0.0 );
+    }
+    out << std::endl;
+}
+
+}
+
+// Zero all timers and counters and restart the total time
+void Profile::Reset()
+{
+    start_ = std::chrono::steady_clock::now();
+    for( unsigned int i = 0; i != NUM_PHASES; i++ )
+    {
+        seconds_[i] = 0.0;
+        calls_[i] = 0;
+        allocations_[i] = 0;
+    }
+    outer_ = 0;
+    inner_ = 0;
+    sweeps_ = 0;
+    low_order_sweeps_ = 0;
+}
+
+// Print summary table with given title
+void Profile::Print( std::ostream &out, const std::string &title ) const
+{
+    const double total = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_ ).count();
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+
+    out << "Profile: " << title << std::endl;
+    out << "  " << std::left << std::setw( 26 ) << "phase" << std::right;
+    out << std::setw( 12 ) << "time (s)" << std::setw( 10 ) << "share" << std::setw( 12 ) << "calls";
+    if( count_allocations )
+    {
+        out << std::setw( 14 ) << "allocations" << std::setw( 14 ) << "allocs/call";
+    }
+    out << std::endl;
+    double timed = 0.0;
+    unsigned long iteration_allocations = 0;
+    for( unsigned int i = 0; i != NUM_PHASES; i++ )
+    {
+        PrintRow( out, phase_names[i], seconds_[i], total, calls_[i], allocations_[i] );
+        timed += seconds_[i];
+        iteration_allocations += i != OUTPUT ? allocations_[i] : 0;
+    }
+    PrintRow( out, "other", total - timed, total, 0, 0 );
+    PrintRow( out, "total", total, total, 1, 0 );
+    out << "  Outer iterations: " << outer_ << "\t";
+    out << "Inner iterations: " << inner_ << "\t";
+    out << "Sweeps: " << sweeps_ << "\t";
+    out << "Low order sweeps: " << low_order_sweeps_ << std::endl;
+
+    // Every phase except output is expected to be free of heap allocations
+    if( count_allocations && iteration_allocations != 0 )
+    {
+        std::cerr << "Warning: " << iteration_allocations << " heap allocations in iteration phases of ";
+        std::cerr << title << std::endl;
+    }
+
+    out.flags( flags );
+    out.precision( precision );
+}
+
+#else
+
+// Zero all timers and counters and restart the total time
+void Profile::Reset() {}
+
+// Print summary table with given title
+void Profile::Print( std::ostream &, const std::string & ) const {}
+
+#endif
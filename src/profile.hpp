@@ -0,0 +1,157 @@
+// profile.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// biscotti includes
+#include "allocationcount.hpp"
+
+// Wall clock timers and iteration counters for the phases of a solve. Compiled
+// in by default; define BISCOTTI_NO_PROFILE to compile them out entirely. When
+// built with BISCOTTI_COUNT_ALLOCATIONS the heap allocations made in each phase
+// are counted as well.
+class Profile
+{
+    public:
+
+        // Enumerate timed phases
+        enum Phase
+        {
+            SCATTER_SOURCE,
+            FISSION_SOURCE,
+            SWEEP,
+            ACCELERATION,
+            K_CONVERGENCE,
+            SCALAR_FLUX_CONVERGENCE,
+            OUTPUT,
+            NUM_PHASES
+        };
+
+        // Accumulates the time from construction to destruction into a phase
+        class ScopedTimer
+        {
+            public:
+
+                // Start timing phase
+                ScopedTimer( Profile &profile, Phase phase );
+
+                // Stop timing phase
+                ~ScopedTimer();
+
+            private:
+
+                // Disable copying
+                ScopedTimer( const ScopedTimer & );
+                ScopedTimer &operator= ( const ScopedTimer & );
+
+#ifndef BISCOTTI_NO_PROFILE
+                // Profile being timed into
+                Profile &profile_;
+
+                // Phase being timed
+                const Phase phase_;
+
+                // Start time
+                const std::chrono::steady_clock::time_point start_;
+
+                // Allocation count at start
+                const unsigned long start_allocations_;
+#endif
+        };
+
+        // Default constructor
+        Profile() { Reset(); };
+
+        // Zero all timers and counters and restart the total time
+        void Reset();
+
+        // Count an outer (k eigenvalue) iteration
+        void CountOuter();
+
+        // Count an inner (scalar flux) iteration
+        void CountInner();
+
+        // Count transport sweeps
+        void CountSweeps( unsigned int count );
+
+        // Count transport sweeps on lower order quadratures made to accelerate
+        // the inner iterations
+        void CountLowOrderSweeps( unsigned long count );
+
+        // Print summary table with given title
+        void Print( std::ostream &out, const std::string &title ) const;
+
+    private:
+
+#ifndef BISCOTTI_NO_PROFILE
+        // Start of total time
+        std::chrono::steady_clock::time_point start_;
+
+        // Accumulated time of each phase (s)
+        double seconds_[ NUM_PHASES ];
+
+        // Number of times each phase was timed
+        unsigned long calls_[ NUM_PHASES ];
+
+        // Heap allocations made in each phase
+        unsigned long allocations_[ NUM_PHASES ];
+
+        // Number of outer iterations
+        unsigned long outer_;
+
+        // Number of inner iterations
+        unsigned long inner_;
+
+        // Number of transport sweeps
+        unsigned long sweeps_;
+
+        // Number of transport sweeps on lower order quadratures
+        unsigned long low_order_sweeps_;
+#endif
+};
+
+#ifndef BISCOTTI_NO_PROFILE
+
+// Start timing phase
+inline Profile::ScopedTimer::ScopedTimer( Profile &profile, Phase phase ):
+    profile_( profile ),
+    phase_( phase ),
+    start_( std::chrono::steady_clock::now() ),
+    start_allocations_( AllocationCount() )
+{}
+
+// Stop timing phase
+inline Profile::ScopedTimer::~ScopedTimer()
+{
+    profile_.seconds_[ phase_ ] += std::chrono::duration<double>( std::chrono::steady_clock::now() - start_ ).count();
+    profile_.calls_[ phase_ ]++;
+    profile_.allocations_[ phase_ ] += AllocationCount() - start_allocations_;
+}
+
+// Count an outer (k eigenvalue) iteration
+inline void Profile::CountOuter() { outer_++; }
+
+// Count an inner (scalar flux) iteration
+inline void Profile::CountInner() { inner_++; }
+
+// Count transport sweeps
+inline void Profile::CountSweeps( unsigned int count ) { sweeps_ += count; }
+
+// Count transport sweeps on lower order quadratures
+inline void Profile::CountLowOrderSweeps( unsigned long count ) { low_order_sweeps_ += count; }
+
+#else
+
+inline Profile::ScopedTimer::ScopedTimer( Profile &, Phase ) {}
+inline Profile::ScopedTimer::~ScopedTimer() {}
+inline void Profile::CountOuter() {}
+inline void Profile::CountInner() {}
+inline void Profile::CountSweeps( unsigned int ) {}
+inline void Profile::CountLowOrderSweeps( unsigned long ) {}
+
+#endif
@@ -0,0 +1,111 @@
+// quadrature.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <vector>
+
+// biscotti includes
+#include "quadrature.hpp"
+
+// Return Gauss-Legendre quadrature of given even order
+const Quadrature &Quadrature::GaussLegendre( unsigned int order )
+{
+    // Check that order is valid
+    assert( order > 0 && order % 2 == 0 );
+
+    // Cache of previously generated quadratures
+    static std::map<unsigned int,Quadrature> cache;
+
+    auto it = cache.find( order );
+    if( it == cache.end() )
+    {
+        it = cache.insert( std::make_pair( order, Quadrature( order ) ) ).first;
+    }
+    return it->second;
+}
+
+// Generate Gauss-Legendre quadrature of given order by Newton iteration
+Quadrature::Quadrature( unsigned int order ):
+    ordinates_( order ),
+    weights_( order ),
+    inv_abs_ordinates_( order )
+{
+    const double pi = std::acos( -1.0 );
+    const unsigned int half = order / 2;
+    // Find each positive root of P_n(x), largest first
+    for( unsigned int i = 0; i != half; i++ )
+    {
+        // Initial guess (Tricomi)
+        double x = std::cos( pi * ( i + 0.75 ) / ( order + 0.5 ) );
+        double dp = 0.0;
+        for( unsigned int iteration = 0; iteration != 100; iteration++ )
+        {
+            // Evaluate P_n(x) with the three term recurrence
+            double p_prev = 1.0;
+            double p = x;
+            for( unsigned int n = 2; n <= order; n++ )
+            {
+                double p_next = ( ( 2.0 * n - 1.0 ) * x * p - ( n - 1.0 ) * p_prev ) / n;
+                p_prev = p;
+                p = p_next;
+            }
+            // Derivative P_n'(x)
+            dp = order * ( x * p - p_prev ) / ( x * x - 1.0 );
+            // Newton step
+            double dx = p / dp;
+            x -= dx;
+            if( std::fabs( dx ) < 1.0e-15 )
+            {
+                break;
+            }
+        }
+        double weight = 2.0 / ( ( 1.0 - x * x ) * dp * dp );
+        // Store symmetric pair, keeping ordinates in ascending order
+        ordinates_[ i ] = -x;
+        weights_[ i ] = weight;
+        ordinates_[ order - 1 - i ] = x;
+        weights_[ order - 1 - i ] = weight;
+        inv_abs_ordinates_[ i ] = 1.0 / x;
+        inv_abs_ordinates_[ order - 1 - i ] = 1.0 / x;
+    }
+
+    // Legendre polynomials of each ordinate by the three term recurrence, for
+    // moments 1 through order - 1 (those the quadrature keeps orthogonal)
+    discrete_to_moment_.resize( order * ( order - 1 ) );
+    moment_to_discrete_.resize( order * ( order - 1 ) );
+    for( unsigned int a = 0; a != order; a++ )
+    {
+        const double mu = ordinates_[ a ];
+        double p_prev = 1.0;
+        double p = mu;
+        for( unsigned int l = 1; l != order; l++ )
+        {
+            discrete_to_moment_[ ( l - 1 ) * order + a ] = weights_[ a ] * p;
+            moment_to_discrete_[ ( l - 1 ) * order + a ] = 0.5 * ( 2.0 * l + 1.0 ) * p;
+            double p_next = ( ( 2.0 * l + 1.0 ) * mu * p - l * p_prev ) / ( l + 1.0 );
+            p_prev = p;
+            p = p_next;
+        }
+    }
+}
+
+// Friend functions //
+
+// Overload operator<<()
+std::ostream &operator<< ( std::ostream &out, const Quadrature &obj )
+{
+    out << std::scientific;
+
+    for( unsigned int i = 0; i != obj.Order(); i++ )
+    {
+        out << "Ordinate: " << obj.ordinates_[ i ] << "\t" << "Weight: " << obj.weights_[ i ] << std::endl;
+    }
+
+    out << std::defaultfloat;
+
+    return out;
+}
@@ -0,0 +1,71 @@
+// quadrature.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <iostream>
+#include <vector>
+
+class Quadrature
+{
+    public:
+
+        // Return Gauss-Legendre quadrature of given even order. Quadratures
+        // are generated on first use and cached for the rest of the run.
+        static const Quadrature &GaussLegendre( unsigned int order );
+
+        // Accessors and mutators //
+
+        // Number of ordinates
+        unsigned int Order() const { return ordinates_.size(); };
+
+        // Ordinates in ascending order (negative ordinates first)
+        const std::vector<double> &Ordinates() const { return ordinates_; };
+
+        // Weights corresponding to each ordinate
+        const std::vector<double> &Weights() const { return weights_; };
+
+        // Reciprocal of the magnitude of each ordinate
+        const std::vector<double> &InverseAbsOrdinates() const { return inv_abs_ordinates_; };
+
+        // Discrete-to-moment matrix for Legendre moments 1 through Order() - 1:
+        // row l - 1 holds w P_l(mu) of each ordinate, so its product with an
+        // angular flux group is the flux moment l
+        const std::vector<double> &DiscreteToMoment() const { return discrete_to_moment_; };
+
+        // Moment-to-discrete matrix for Legendre moments 1 through Order() - 1:
+        // row l - 1 holds ( 2 l + 1 ) / 2 P_l(mu) of each ordinate, so its
+        // transpose maps source moments to the angular source of each ordinate
+        const std::vector<double> &MomentToDiscrete() const { return moment_to_discrete_; };
+
+        // Friend functions //
+
+        // Overload operator<<()
+        friend std::ostream &operator<< ( std::ostream &out, const Quadrature &obj );
+
+    private:
+
+        // Generate Gauss-Legendre quadrature of given order by Newton iteration
+        Quadrature( unsigned int order );
+
+        // Ordinates
+        std::vector<double> ordinates_;
+
+        // Weights
+        std::vector<double> weights_;
+
+        // Reciprocal of the magnitude of each ordinate
+        std::vector<double> inv_abs_ordinates_;
+
+        // Discrete-to-moment matrix, one row of Order() values per moment
+        std::vector<double> discrete_to_moment_;
+
+        // Moment-to-discrete matrix, one row of Order() values per moment
+        std::vector<double> moment_to_discrete_;
+};
+
+// Friend functions //
+
+// Overload operator<<()
+std::ostream &operator<< ( std::ostream &out, const Quadrature &obj );
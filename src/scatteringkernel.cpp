@@ -0,0 +1,71 @@
+// scatteringkernel.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <vector>
+
+// biscotti includes
+#include "groupdependent.hpp"
+#include "groupgroupdependent.hpp"
+#include "scatteringkernel.hpp"
+
+// Compress scattering cross sections defined on the given energy groups
+ScatteringKernel::ScatteringKernel( const GroupGroupDependent &xsec, const GroupDependent &energy_groups )
+{
+    // Index energy groups, slowest first
+    std::map<double,unsigned int> index;
+    for( auto it = energy_groups.slowest(); it != std::next( energy_groups.fastest() ); it++ )
+    {
+        index.insert( std::make_pair( it->first, index.size() ) );
+    }
+
+    // Collect nonzero entries of each destination group. Source groups are
+    // visited in increasing energy so each row is summed in the same order as
+    // GroupGroupDependent's operator*().
+    std::vector<std::vector<std::pair<unsigned int,double>>> rows( index.size() );
+    for( auto from_it = xsec.slowest(); from_it != std::next( xsec.fastest() ); from_it++ )
+    {
+        assert( index.count( from_it->first ) != 0 );
+        const GroupDependent &outscatter = from_it->second;
+        for( auto to_it = outscatter.slowest(); to_it != std::next( outscatter.fastest() ); to_it++ )
+        {
+            assert( index.count( to_it->first ) != 0 );
+            if( to_it->second != 0.0 )
+            {
+                rows[ index.at( to_it->first ) ].push_back( std::make_pair( index.at( from_it->first ), to_it->second ) );
+            }
+        }
+    }
+
+    // Compress rows
+    row_begin_.push_back( 0 );
+    for( auto row_it = rows.begin(); row_it != rows.end(); row_it++ )
+    {
+        for( auto entry_it = row_it->begin(); entry_it != row_it->end(); entry_it++ )
+        {
+            from_.push_back( entry_it->first );
+            value_.push_back( entry_it->second );
+        }
+        row_begin_.push_back( from_.size() );
+    }
+}
+
+// Friend functions //
+
+// Overload operator<<()
+std::ostream &operator<< ( std::ostream &out, const ScatteringKernel &obj )
+{
+    for( unsigned int to = 0; to != obj.NumGroups(); to++ )
+    {
+        out << "To group index: " << to << "\t";
+        for( unsigned int k = obj.row_begin_[ to ]; k != obj.row_begin_[ to + 1 ]; k++ )
+        {
+            out << "(" << obj.from_[ k ] << ", " << obj.value_[ k ] << ") ";
+        }
+        out << std::endl;
+    }
+    return out;
+}
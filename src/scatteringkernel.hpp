@@ -0,0 +1,99 @@
+// scatteringkernel.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// biscotti includes
+#include "groupdependent.hpp"
+#include "groupgroupdependent.hpp"
+
+// Group-to-group scattering matrix compressed to its nonzero entries. Entries
+// are stored by destination group (compressed sparse rows), so the scattering
+// source into each group is a short dot product with the scalar flux. Groups
+// are indexed slowest first, as in AngularFlux.
+class ScatteringKernel
+{
+    public:
+
+        // Compress scattering cross sections defined on the given energy groups
+        ScatteringKernel( const GroupGroupDependent &xsec, const GroupDependent &energy_groups );
+
+        // Compute scattering source into each group from the scalar flux
+        void Apply( const double *scl_flux, double *scat_src ) const
+        {
+            for( unsigned int to = 0; to + 1 < row_begin_.size(); to++ )
+            {
+                double sum = 0.0;
+                for( unsigned int k = row_begin_[ to ]; k != row_begin_[ to + 1 ]; k++ )
+                {
+                    sum += value_[ k ] * scl_flux[ from_[ k ] ];
+                }
+                scat_src[ to ] = sum;
+            }
+        };
+
+        // Compute scattering source into group to from the scalar flux, leaving
+        // out scattering within the group
+        double InScatter( unsigned int to, const double *scl_flux ) const
+        {
+            double sum = 0.0;
+            for( unsigned int k = row_begin_[ to ]; k != row_begin_[ to + 1 ]; k++ )
+            {
+                sum += from_[ k ] != to ? value_[ k ] * scl_flux[ from_[ k ] ] : 0.0;
+            }
+            return sum;
+        };
+
+        // Return cross section of scattering within a group
+        double SelfScatter( unsigned int group ) const
+        {
+            for( unsigned int k = row_begin_[ group ]; k != row_begin_[ group + 1 ]; k++ )
+            {
+                if( from_[ k ] == group )
+                {
+                    return value_[ k ];
+                }
+            }
+            return 0.0;
+        };
+
+        // Accessors and mutators //
+
+        // Number of energy groups
+        unsigned int NumGroups() const { return row_begin_.size() - 1; };
+
+        // Number of nonzero entries
+        unsigned int NumNonzeros() const { return value_.size(); };
+
+        // Heap memory used (bytes)
+        std::size_t MemoryUsage() const
+        {
+            return sizeof( unsigned int ) * ( row_begin_.capacity() + from_.capacity() ) + sizeof( double ) * value_.capacity();
+        };
+
+        // Friend functions //
+
+        // Overload operator<<()
+        friend std::ostream &operator<< ( std::ostream &out, const ScatteringKernel &obj );
+
+    private:
+
+        // Index of first entry of each destination group, plus one past the end
+        std::vector<unsigned int> row_begin_;
+
+        // Source group of each entry
+        std::vector<unsigned int> from_;
+
+        // Cross section of each entry
+        std::vector<double> value_;
+};
+
+// Friend functions //
+
+// Overload operator<<()
+std::ostream &operator<< ( std::ostream &out, const ScatteringKernel &obj );
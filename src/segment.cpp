@@ -3,15 +3,14 @@
 
 // std includes
 #include <iostream>
-#include <map>
+#include <memory>
 
 // biscotti includes
-#include "angledependent.hpp"
-#include "material.hpp"
+#include "flatmaterial.hpp"
 #include "segment.hpp"
 
 // Default constructor
-Segment::Segment( Material material, double width, unsigned int num_cells, double scl_flux_guess, double adj_scl_flux_guess ):
+Segment::Segment( std::shared_ptr<const FlatMaterial> material, double width, unsigned int num_cells, double scl_flux_guess, double adj_scl_flux_guess ):
     material_( material ),
     width_( width ),
     num_cells_( num_cells ),
@@ -29,8 +28,8 @@ std::ostream &operator<< ( std::ostream &out, const Segment &obj )
     out << "Number of cells: " << obj.num_cells_ << std::endl;
     out << "Cell width: " << obj.cell_width_ << std::endl;
     out << "Scalar flux guess: " << obj.scl_flux_guess_ << std::endl;
-    out << "Material address: " << &obj.material_ << std::endl;
-    out << "Material: \n\n" << obj.material_ << std::endl;
+    out << "Material address: " << obj.material_.get() << std::endl;
+    out << "Material: \n\n" << obj.MaterialReference() << std::endl;
 
     return out;
 }
@@ -5,24 +5,30 @@
 
 // std includes
 #include <iostream>
-#include <map>
+#include <memory>
 
 // biscotti includes
-#include "angledependent.hpp"
+#include "flatmaterial.hpp"
 #include "material.hpp"
-#include "settings.hpp"
 
 class Segment
 {
     public:
 
         // Default constructor
-        Segment( Material material, double width, unsigned int num_cells, double scl_flux_guess, double adj_scl_flux_guess );
+        Segment( std::shared_ptr<const FlatMaterial> material, double width, unsigned int num_cells, double scl_flux_guess, double adj_scl_flux_guess );
 
         // Accessors and mutators //
 
         // Return const reference to material_
-        const Material &MaterialReference() const { return material_; };
+        const Material &MaterialReference() const { return material_->MaterialReference(); };
+
+        // Return const reference to flattened material (shared by all segments
+        // of the same material)
+        const FlatMaterial &FlatMaterialReference() const { return *material_; };
+
+        // Return shared flattened material
+        const std::shared_ptr<const FlatMaterial> &FlatMaterialPointer() const { return material_; };
 
         // Read width
         double Width() const { return width_; };
@@ -47,7 +53,7 @@ class Segment
     private:
 
         // Material
-        const Material material_;
+        const std::shared_ptr<const FlatMaterial> material_;
 
         // Width
         const double width_;
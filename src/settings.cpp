@@ -8,9 +8,47 @@
 #include "settings.hpp"
 
 // Default constructor
-Settings::Settings()
+Settings::Settings():
+    left_bc_( VACUUM ),
+    right_bc_( REFLECTING ),
+    k_guess_( 1.0 ),
+    adj_k_guess_( 1.0 ),
+    fission_source_guess_( 1.0 ),
+    adj_fission_source_guess_( 1.0 ),
+    k_tol_( 1.0e-5 ),
+    scl_flux_tol_( 1.0e-5 ),
+    seed_( 10 ),
+    progress_period_( 10 ),
+    quadrature_order_( 64 ),
+    angular_flux_storage_( FULL ),
+    angular_flux_precision_( DOUBLE ),
+    spatial_scheme_( DIAMOND_DIFFERENCE ),
+    adaptive_levels_( 4 ),
+    adaptive_tol_( 1.0e-3 ),
+    scattering_order_( 0 ),
+    detect_symmetry_( true ),
+    diffusion_guess_( true ),
+    mesh_sequence_factor_( 8 ),
+    inner_acceleration_( NONE ),
+    angular_multigrid_order_( 4 ),
+    adaptive_inner_tol_( false ),
+    inner_tol_ratio_( 1.0 ),
+    anderson_depth_( 0 ),
+    krylov_size_( 30 ),
+    num_threads_( 1 )
 {}
 
+// Return deck name of a spatial scheme
+const char *Settings::SchemeName( Scheme scheme )
+{
+    switch( scheme )
+    {
+        case LINEAR_DISCONTINUOUS: return "linear_discontinuous";
+        case STEP_CHARACTERISTIC: return "step_characteristic";
+        default: return "diamond_difference";
+    }
+}
+
 // Friend functions //
 
 // Overload I/O operators
@@ -21,5 +59,23 @@ std::ostream &operator<< ( std::ostream &out, const Settings &obj )
     out << "Scalar flux convergence tolerance: " << obj.scl_flux_tol_ << std::endl;
     out << "Seed: " << obj.seed_ << std::endl;
     out << "Progress report period: " << obj.progress_period_ << std::endl;
+    out << "Quadrature order: " << obj.quadrature_order_ << std::endl;
+    out << "Angular flux storage: " << ( obj.angular_flux_storage_ == Settings::EDGE ? "edge" : "full" ) << std::endl;
+    out << "Angular flux precision: " << ( obj.angular_flux_precision_ == Settings::FLOAT ? "float" : "double" ) << std::endl;
+    out << "Spatial scheme: " << Settings::SchemeName( obj.spatial_scheme_ ) << std::endl;
+    out << "Adaptive refinement levels: " << obj.adaptive_levels_ << std::endl;
+    out << "Adaptive refinement tolerance: " << obj.adaptive_tol_ << std::endl;
+    out << "Scattering order: " << obj.scattering_order_ << std::endl;
+    out << "Right boundary condition: " << ( obj.right_bc_ == Settings::VACUUM ? "vacuum" : "reflecting" ) << std::endl;
+    out << "Symmetry detection: " << ( obj.detect_symmetry_ ? "auto" : "off" ) << std::endl;
+    out << "Initial guess: " << ( obj.diffusion_guess_ ? "diffusion" : "flat" ) << std::endl;
+    out << "Mesh sequence factor: " << obj.mesh_sequence_factor_ << std::endl;
+    out << "Inner acceleration: " << ( obj.inner_acceleration_ == Settings::ANGULAR_MULTIGRID ? "angular_multigrid" : "none" ) << std::endl;
+    out << "Angular multigrid order: " << obj.angular_multigrid_order_ << std::endl;
+    out << "Inner tolerance: " << ( obj.adaptive_inner_tol_ ? "adaptive" : "fixed" ) << std::endl;
+    out << "Inner tolerance ratio: " << obj.inner_tol_ratio_ << std::endl;
+    out << "Anderson mixing depth: " << obj.anderson_depth_ << std::endl;
+    out << "Krylov size: " << obj.krylov_size_ << std::endl;
+    out << "Threads: " << obj.num_threads_ << std::endl;
     return out;
 }
@@ -18,6 +18,48 @@ class Settings
             REFLECTING
         };
 
+        // Enumerate angular flux storage. FULL keeps the midpoint and outgoing
+        // angular fluxes of every cell; EDGE keeps only scalar fluxes per cell
+        // and a running edge flux during sweeps.
+        enum AngularStorage
+        {
+            FULL,
+            EDGE
+        };
+
+        // Enumerate precision of stored angular fluxes. Scalar fluxes, sources
+        // and convergence checks are always computed in double.
+        enum Precision
+        {
+            DOUBLE,
+            FLOAT
+        };
+
+        // Enumerate spatial discretizations of the sweep. DIAMOND_DIFFERENCE
+        // carries the cell average only; LINEAR_DISCONTINUOUS also carries the
+        // linear moment of the flux and sources in each cell.
+        // STEP_CHARACTERISTIC integrates a flat source exactly along each
+        // ordinate and never produces negative fluxes on thick cells.
+        enum Scheme
+        {
+            DIAMOND_DIFFERENCE,
+            LINEAR_DISCONTINUOUS,
+            STEP_CHARACTERISTIC
+        };
+
+        // Enumerate acceleration of the inner (scattering) iterations.
+        // ANGULAR_MULTIGRID corrects each sweep with the scalar flux error
+        // estimated by sweeps on quadratures of half the order, down to the
+        // angular multigrid order, and by diffusion below that.
+        enum Acceleration
+        {
+            NONE,
+            ANGULAR_MULTIGRID
+        };
+
+        // Return deck name of a spatial scheme
+        static const char *SchemeName( Scheme scheme );
+
         // Default constructor
         Settings();
 
@@ -27,6 +69,10 @@ class Settings
         void SetLeftBC( BoundaryCondition bc ) { left_bc_ = bc; };
         BoundaryCondition LeftBC() const { return left_bc_; };
 
+        // Right boundary condition
+        void SetRightBC( BoundaryCondition bc ) { right_bc_ = bc; };
+        BoundaryCondition RightBC() const { return right_bc_; };
+
         // Fundamental k eigenvalue guess
         void SetKGuess( double k_guess ) { k_guess_ = k_guess; };
         double KGuess() const { return k_guess_; };
@@ -59,6 +105,81 @@ class Settings
         void SetProgressPeriod( unsigned int period ) { progress_period_ = period; };
         unsigned int ProgressPeriod() const { return progress_period_; };
 
+        // Number of Gauss-Legendre ordinates
+        void SetQuadratureOrder( unsigned int order ) { quadrature_order_ = order; };
+        unsigned int QuadratureOrder() const { return quadrature_order_; };
+
+        // Angular flux storage
+        void SetAngularFluxStorage( AngularStorage storage ) { angular_flux_storage_ = storage; };
+        AngularStorage AngularFluxStorage() const { return angular_flux_storage_; };
+
+        // Angular flux precision
+        void SetAngularFluxPrecision( Precision precision ) { angular_flux_precision_ = precision; };
+        Precision AngularFluxPrecision() const { return angular_flux_precision_; };
+
+        // Spatial discretization of the sweep
+        void SetSpatialScheme( Scheme scheme ) { spatial_scheme_ = scheme; };
+        Scheme SpatialScheme() const { return spatial_scheme_; };
+
+        // Maximum number of times adaptive mesh refinement halves a cell
+        void SetAdaptiveLevels( unsigned int levels ) { adaptive_levels_ = levels; };
+        unsigned int AdaptiveLevels() const { return adaptive_levels_; };
+
+        // Error indicator above which adaptive mesh refinement halves a cell
+        void SetAdaptiveTol( double adaptive_tol ) { adaptive_tol_ = adaptive_tol; };
+        double AdaptiveTol() const { return adaptive_tol_; };
+
+        // Highest Legendre moment of scattering kept (0 for isotropic)
+        void SetScatteringOrder( unsigned int scattering_order ) { scattering_order_ = scattering_order; };
+        unsigned int ScatteringOrder() const { return scattering_order_; };
+
+        // Solve only the left half of a mirror symmetric slab when possible
+        void SetDetectSymmetry( bool detect_symmetry ) { detect_symmetry_ = detect_symmetry; };
+        bool DetectSymmetry() const { return detect_symmetry_; };
+
+        // Start eigenvalue solves from a diffusion solution instead of the
+        // flat guesses
+        void SetDiffusionGuess( bool diffusion_guess ) { diffusion_guess_ = diffusion_guess; };
+        bool DiffusionGuess() const { return diffusion_guess_; };
+
+        // Factor the cells of each segment are coarsened by on the first mesh
+        // of a mesh sequenced solve
+        void SetMeshSequenceFactor( unsigned int factor ) { mesh_sequence_factor_ = factor; };
+        unsigned int MeshSequenceFactor() const { return mesh_sequence_factor_; };
+
+        // Acceleration of the inner iterations
+        void SetInnerAcceleration( Acceleration acceleration ) { inner_acceleration_ = acceleration; };
+        Acceleration InnerAcceleration() const { return inner_acceleration_; };
+
+        // Lowest quadrature order of angular multigrid corrections
+        void SetAngularMultigridOrder( unsigned int order ) { angular_multigrid_order_ = order; };
+        unsigned int AngularMultigridOrder() const { return angular_multigrid_order_; };
+
+        // Loosen the scalar flux tolerance of the inner iterations while the
+        // outer iterations are still far from converged
+        void SetAdaptiveInnerTol( bool adaptive_inner_tol ) { adaptive_inner_tol_ = adaptive_inner_tol; };
+        bool AdaptiveInnerTol() const { return adaptive_inner_tol_; };
+
+        // Ratio of an adaptive inner tolerance to the change of the last outer
+        // iteration
+        void SetInnerTolRatio( double inner_tol_ratio ) { inner_tol_ratio_ = inner_tol_ratio; };
+        double InnerTolRatio() const { return inner_tol_ratio_; };
+
+        // Number of previous outer iterations Anderson mixing of the fission
+        // source combines, 0 for plain power iteration
+        void SetAndersonDepth( unsigned int depth ) { anderson_depth_ = depth; };
+        unsigned int AndersonDepth() const { return anderson_depth_; };
+
+        // Largest number of Krylov iterations of a Newton step of a Jacobian
+        // free Newton Krylov eigenvalue solve
+        void SetKrylovSize( unsigned int size ) { krylov_size_ = size; };
+        unsigned int KrylovSize() const { return krylov_size_; };
+
+        // Number of threads the per cell source updates and convergence
+        // checks of each sense are split over
+        void SetNumThreads( unsigned int num_threads ) { num_threads_ = num_threads; };
+        unsigned int NumThreads() const { return num_threads_; };
+
         // Friend functions //
  
         // Overload I/O operators
@@ -69,6 +190,9 @@ class Settings
         // Left boundary condition
         BoundaryCondition left_bc_;
 
+        // Right boundary condition
+        BoundaryCondition right_bc_;
+
         // Fundamental k eigenvalue guess
         double k_guess_;
 
@@ -92,6 +216,59 @@ class Settings
 
         // Period of progress reports
         unsigned int progress_period_;
+
+        // Number of Gauss-Legendre ordinates
+        unsigned int quadrature_order_;
+
+        // Angular flux storage
+        AngularStorage angular_flux_storage_;
+
+        // Angular flux precision
+        Precision angular_flux_precision_;
+
+        // Spatial discretization of the sweep
+        Scheme spatial_scheme_;
+
+        // Maximum number of times adaptive mesh refinement halves a cell
+        unsigned int adaptive_levels_;
+
+        // Error indicator above which adaptive mesh refinement halves a cell
+        double adaptive_tol_;
+
+        // Highest Legendre moment of scattering kept
+        unsigned int scattering_order_;
+
+        // Solve only the left half of a mirror symmetric slab when possible
+        bool detect_symmetry_;
+
+        // Start eigenvalue solves from a diffusion solution
+        bool diffusion_guess_;
+
+        // Factor the cells of each segment are coarsened by on the first mesh
+        // of a mesh sequenced solve
+        unsigned int mesh_sequence_factor_;
+
+        // Acceleration of the inner iterations
+        Acceleration inner_acceleration_;
+
+        // Lowest quadrature order of angular multigrid corrections
+        unsigned int angular_multigrid_order_;
+
+        // Loosen the inner tolerance while the outer iterations are far from
+        // converged
+        bool adaptive_inner_tol_;
+
+        // Ratio of an adaptive inner tolerance to the last outer change
+        double inner_tol_ratio_;
+
+        // Number of previous outer iterations Anderson mixing combines
+        unsigned int anderson_depth_;
+
+        // Largest number of Krylov iterations of a Newton step
+        unsigned int krylov_size_;
+
+        // Number of threads of the per cell loops of each sense
+        unsigned int num_threads_;
 };
 
 // Friend functions //
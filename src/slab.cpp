@@ -4,76 +4,370 @@
 // std includes
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <numeric>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 // biscotti includes
+#include "adaptivemesh.hpp"
 #include "cell.hpp"
+#include "diffusion.hpp"
+#include "gmres.hpp"
 #include "groupdependent.hpp"
 #include "layout.hpp"
+#include "profile.hpp"
 #include "settings.hpp"
 #include "slab.hpp"
+#include "sweepkernel.hpp"
+
+namespace
+{
+
+// Return settings of the angular multigrid level below settings: half the
+// quadrature order rounded up to even, but no lower than the lowest order
+Settings CorrectionSettings( const Settings &settings )
+{
+    Settings correction = settings;
+    const unsigned int order = std::max( ( settings.QuadratureOrder() / 2 + 1 ) / 2 * 2,
+            settings.AngularMultigridOrder() );
+    correction.SetQuadratureOrder( order );
+    correction.SetScatteringOrder( std::min( settings.ScatteringOrder(), order - 1 ) );
+    // Corrections only sweep, which is not split over threads
+    correction.SetNumThreads( 1 );
+    return correction;
+}
+
+// Return the Euclidean norm of the first size values of x
+double Norm( const std::vector<double> &x, std::size_t size )
+{
+    double sum = 0.0;
+    for( std::size_t i = 0; i != size; i++ )
+    {
+        sum += x[ i ] * x[ i ];
+    }
+    return std::sqrt( sum );
+}
+
+// Return the largest residual of a scalar flux value relative to the largest
+// value of its group, both of num_cells cells slowest group first
+double MaxRelativeResidual( const std::vector<double> &residual, const std::vector<double> &x, std::size_t num_cells,
+        unsigned int num_groups )
+{
+    double max_error = 0.0;
+    for( unsigned int g = 0; g != num_groups; g++ )
+    {
+        double max_value = 0.0;
+        double max_residual = 0.0;
+        for( std::size_t i = 0; i != num_cells; i++ )
+        {
+            max_value = std::max( max_value, std::fabs( x[ i * num_groups + g ] ) );
+            max_residual = std::max( max_residual, std::fabs( residual[ i * num_groups + g ] ) );
+        }
+        if( max_value > 0.0 )
+        {
+            max_error = std::max( max_error, max_residual / max_value );
+        }
+    }
+    return max_error;
+}
+
+}
 
 // Default constructor
-Slab::Slab( const Settings &settings, const Layout &layout ):
+Slab::Slab( const Settings &settings, const Layout &layout, bool mirrored ):
     settings_( settings ),
     layout_( layout ),
-    cur_k_( settings_.KGuess() ),
-    adj_cur_k_( settings_.AdjKGuess() ),
-    cur_fission_source_( settings_.FissionSourceGuess() ),
-    adj_cur_fission_source_( settings_.AdjFissionSourceGuess() ),
-    cells_( layout_.GenerateCells( settings_, cur_k_, adj_cur_k_ ) ),
+    mirrored_( mirrored ),
+    cur_k_{ settings_.KGuess(), settings_.AdjKGuess() },
+    // A half slab produces half the fission source of the full slab
+    cur_fission_source_{ ( mirrored ? 0.5 : 1.0 ) * settings_.FissionSourceGuess(),
+        ( mirrored ? 0.5 : 1.0 ) * settings_.AdjFissionSourceGuess() },
+    outer_change_{ 1.0, 1.0 },
+    cells_( layout_.GenerateCells( settings_ ) ),
+    bnd_angflux_( 2, AngularFlux( cells_.front().Energies(), cells_.front().QuadratureReference(), 0.0,
+                settings_.AngularFluxPrecision() ) ),
+    edge_angflux_{ AngularFlux( cells_.front().Energies(), cells_.front().QuadratureReference(),
+            cells_.front().ScalarFluxGuess<FORWARD>(), settings_.AngularFluxPrecision() ),
+        AngularFlux( cells_.front().Energies(), cells_.front().QuadratureReference(),
+            cells_.front().ScalarFluxGuess<ADJOINT>(), settings_.AngularFluxPrecision() ) },
+    mid_angflux_( bnd_angflux_ ),
     energy_groups_( layout_.GenerateEnergyGroups() ),
-    speeds_( GroupDependent( energy_groups_, layout_.GenerateSpeedGroups() ) )
-{}
+    speeds_( GroupDependent( energy_groups_, layout_.GenerateSpeedGroups() ) ),
+    sweep_kernels_( SelectSweepKernels( settings_.SpatialScheme(), settings_.QuadratureOrder(), energy_groups_.size(),
+                settings_.ScatteringOrder() != 0 ) ),
+    stream_{ &std::cout, &std::cout },
+    num_sweeps_{ 0, 0 },
+    profile_{ &profiles_[ FORWARD ], &profiles_[ ADJOINT ] },
+    cell_sclflux_{ std::vector<double>( energy_groups_.size() ), std::vector<double>( energy_groups_.size() ) },
+    num_low_order_sweeps_{ 0, 0 }
+{
+    // Each angular multigrid level but the lowest builds the level below it;
+    // the lowest hands the error on to diffusion
+    if( settings_.InnerAcceleration() == Settings::ANGULAR_MULTIGRID )
+    {
+        if( settings_.QuadratureOrder() > settings_.AngularMultigridOrder() )
+        {
+            correction_.reset( new Slab( CorrectionSettings( settings_ ), layout_, mirrored_ ) );
+        }
+        else
+        {
+            diffusion_.emplace_back( layout_, settings_ );
+            diffusion_.emplace_back( layout_, settings_ );
+        }
+        error_source_[ FORWARD ].resize( cells_.size() * energy_groups_.size() );
+        error_source_[ ADJOINT ].resize( cells_.size() * energy_groups_.size() );
+    }
+    if( settings_.AdaptiveInnerTol() )
+    {
+        cell_fission_source_[ FORWARD ].resize( cells_.size() );
+        cell_fission_source_[ ADJOINT ].resize( cells_.size() );
+    }
+    if( settings_.AndersonDepth() != 0 )
+    {
+        anderson_.emplace_back( cells_.size(), settings_.AndersonDepth() );
+        anderson_.emplace_back( cells_.size(), settings_.AndersonDepth() );
+        for( unsigned int s = FORWARD; s <= ADJOINT; s++ )
+        {
+            fission_shape_[ s ].resize( cells_.size() );
+            mixed_fission_shape_[ s ].resize( cells_.size() );
+        }
+    }
+    for( unsigned int s = FORWARD; s <= ADJOINT; s++ )
+    {
+        thread_pools_[ s ].reset( new ThreadPool( settings_.NumThreads() ) );
+        fission_source_sums_.emplace_back( cells_.size() );
+        chunk_errors_[ s ].resize( settings_.NumThreads() );
+        chunk_cells_[ s ].resize( settings_.NumThreads() );
+    }
+}
 
 // Solve for k eigenvalue
 void Slab::EigenvalueSolve()
 {
-    // Iterate while k is not converged
-    while( !KConverged() )
+    SolveEigenvalue<FORWARD>();
+}
+
+// [Adjoint] Solve for k eigenvalue
+void Slab::AdjEigenvalueSolve()
+{
+    SolveEigenvalue<ADJOINT>();
+}
+
+// Solve forward and adjoint k eigenvalue problems together
+void Slab::FusedEigenvalueSolve()
+{
+    // Both senses share one profile since their sweeps cannot be told apart
+    Profile &profile = profiles_[ FORWARD ];
+    profile_[ ADJOINT ] = &profile;
+    profile.Reset();
+    if( !anderson_.empty() )
     {
-        // Iterate while scalar flux is not converged
+        anderson_[ FORWARD ].Reset();
+        anderson_[ ADJOINT ].Reset();
+    }
+    // A diffusion guess is consistent with its k, so at least one outer
+    // iteration is forced after it
+    const bool fwd_guess = DiffusionGuess<FORWARD>();
+    const bool adj_guess = DiffusionGuess<ADJOINT>();
+    bool force_outer = fwd_guess || adj_guess;
+    // Iterate while either k is not converged, or the last inner iterations
+    // stopped short of the scalar flux tolerance. Both are checked every
+    // outer iteration so the two problems stay in lockstep.
+    bool converged = false;
+    double inner_tol = settings_.SclFluxTol();
+    while( !converged )
+    {
+        bool k_converged = KConverged<FORWARD>();
+        bool adj_k_converged = KConverged<ADJOINT>();
+        converged = k_converged && adj_k_converged && !force_outer && inner_tol <= settings_.SclFluxTol();
+        if( converged )
+        {
+            break;
+        }
+        force_outer = false;
+        profile.CountOuter();
+        inner_tol = std::min( InnerTolerance<FORWARD>(), InnerTolerance<ADJOINT>() );
+        // Iterate while either scalar flux is not converged
         unsigned int i = 0;
-        do
+        bool scl_flux_converged = false;
+        while( !scl_flux_converged )
         {
             i++;
-            UpdateScatterSources();
-            ImposeLeftBC();
-            SweepRight();
-            cells_.back().RightReflectBoundary();
-            SweepLeft();
-        } while( !ScalarFluxConverged( i ) );
+            profile.CountInner();
+            UpdateScatterSources<FORWARD>();
+            UpdateScatterSources<ADJOINT>();
+            {
+                Profile::ScopedTimer timer( profile, Profile::SWEEP );
+                if( settings_.AngularFluxStorage() == Settings::EDGE )
+                {
+                    ImposeEdgeLeftBC<FORWARD>();
+                    ImposeEdgeLeftBC<ADJOINT>();
+                    EdgeFusedSweep<RIGHT>();
+                    ImposeEdgeRightBC<FORWARD>();
+                    ImposeEdgeRightBC<ADJOINT>();
+                    EdgeFusedSweep<LEFT>();
+                }
+                else
+                {
+                    ImposeLeftBC<FORWARD>();
+                    ImposeLeftBC<ADJOINT>();
+                    FusedSweep<RIGHT>();
+                    ImposeRightBC<FORWARD>();
+                    ImposeRightBC<ADJOINT>();
+                    FusedSweep<LEFT>();
+                }
+                num_sweeps_[ FORWARD ]++;
+                num_sweeps_[ ADJOINT ]++;
+                profile.CountSweeps( 2 );
+            }
+            Accelerate<FORWARD>();
+            Accelerate<ADJOINT>();
+            bool fwd_converged = ScalarFluxConverged<FORWARD>( i, inner_tol );
+            bool adj_converged = ScalarFluxConverged<ADJOINT>( i, inner_tol );
+            scl_flux_converged = fwd_converged && adj_converged;
+        }
     }
-    PrintScalarFluxes();
+    PrintScalarFluxes<FORWARD>();
+    PrintScalarFluxes<ADJOINT>();
+    profile.Print( *stream_[ FORWARD ], "fused eigenvalue" );
+    profile_[ ADJOINT ] = &profiles_[ ADJOINT ];
 }
 
-// [Adjoint] Solve for k eigenvalue
-void Slab::AdjEigenvalueSolve()
+// Solve forward and adjoint k eigenvalue problems concurrently
+void Slab::ConcurrentEigenvalueSolve()
 {
-    // Iterate while k is not converged
-    while( !AdjKConverged() )
+    // Each sense writes its progress and results to its own stream so the
+    // output of the two solves does not interleave. The adjoint solve runs on
+    // a second thread; the two touch disjoint cell states and eigenvalues.
+    std::ostringstream fwd_out, adj_out;
+    stream_[ FORWARD ] = &fwd_out;
+    stream_[ ADJOINT ] = &adj_out;
+    std::thread adj_thread( &Slab::SolveEigenvalue<ADJOINT>, this, false );
+    SolveEigenvalue<FORWARD>();
+    adj_thread.join();
+    stream_[ FORWARD ] = &std::cout;
+    stream_[ ADJOINT ] = &std::cout;
+    std::cout << fwd_out.str() << adj_out.str() << std::flush;
+}
+
+// Solve for k eigenvalue on a mesh adapted to the scalar flux
+void Slab::AdaptiveEigenvalueSolve()
+{
+    AdaptiveMesh mesh( layout_ );
+    // Diamond difference on the coarse base mesh strays too far from diffusion
+    // for a diffusion guess to pay off, and finer levels start from the
+    // previous level
+    Settings settings = settings_;
+    settings.SetDiffusionGuess( false );
+    const unsigned int num_groups = energy_groups_.size();
+    std::vector<double> widths;
+    std::vector<double> scl_flux;
+    for( unsigned int level = 0; ; level++ )
     {
-        // Iterate while scalar flux is not converged
-        unsigned int i = 0;
-        do
+        // Progress of the solve at each level is discarded
+        std::ostream null_out( nullptr );
+        const std::vector<double> level_widths = mesh.CellWidths();
+        Slab slab( settings, mesh.GenerateLayout() );
+        slab.stream_[ FORWARD ] = &null_out;
+        slab.stream_[ ADJOINT ] = &null_out;
+        if( !scl_flux.empty() )
         {
-            i++;
-            AdjUpdateScatterSources();
-            AdjImposeLeftBC();
-            AdjSweepRight();
-            cells_.back().AdjRightReflectBoundary();
-            AdjSweepLeft();
-        } while( !AdjScalarFluxConverged( i ) );
+            const std::vector<double> guess = AdaptiveMesh::Project( scl_flux, num_groups, widths, level_widths );
+            for( std::size_t i = 0; i != slab.cells_.size(); i++ )
+            {
+                slab.cells_[ i ].SetScalarFlux<FORWARD>( &guess[ i * num_groups ] );
+            }
+        }
+        // A flux guess consistent with the k guess would pass the first k
+        // check without a sweep
+        auto start = std::chrono::steady_clock::now();
+        slab.SolveEigenvalue<FORWARD>( !scl_flux.empty() );
+        const double solve_time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+        widths = level_widths;
+        scl_flux.clear();
+        for( auto cell_it = slab.cells_.begin(); cell_it != slab.cells_.end(); cell_it++ )
+        {
+            const std::vector<double> &values = cell_it->ScalarFluxValues<FORWARD>();
+            scl_flux.insert( scl_flux.end(), values.begin(), values.end() );
+        }
+        std::cout << "Refinement level: " << level << "\t";
+        std::cout << "Cells: " << slab.NumCells() << "\t";
+        std::cout << "Finest cell level: " << mesh.MaxLevel() << "\t";
+        std::cout << "k eigenvalue: " << slab.KEigenvalue() << "\t";
+        std::cout << "Sweeps: " << slab.NumSweeps() << "\t";
+        std::cout << "Solve time (s): " << solve_time << std::endl;
+
+        // The next level starts from this k and fission source
+        settings.SetKGuess( slab.cur_k_[ FORWARD ] );
+        settings.SetFissionSourceGuess( slab.cur_fission_source_[ FORWARD ] );
+        if( level == settings_.AdaptiveLevels() ||
+                !mesh.Adapt( scl_flux, num_groups, settings_.AdaptiveTol(), settings_.AdaptiveLevels() ) )
+        {
+            slab.stream_[ FORWARD ] = &std::cout;
+            slab.PrintScalarFluxes<FORWARD>();
+            std::cout << "#adaptive_cell_widths" << std::endl;
+            for( auto it = widths.begin(); it != widths.end(); it++ )
+            {
+                std::cout << *it;
+                it == std::prev( widths.end() ) ? std::cout << std::endl : std::cout << ",";
+            }
+            std::cout << "#end" << std::endl;
+            cur_k_[ FORWARD ] = slab.cur_k_[ FORWARD ];
+            break;
+        }
     }
-    AdjPrintScalarFluxes();
+}
+
+// Solve for k eigenvalue on successively finer meshes
+void Slab::MeshSequencedEigenvalueSolve()
+{
+    // Progress of the solves on the coarse meshes is discarded
+    std::ostream null_out( nullptr );
+    Settings settings = settings_;
+    std::unique_ptr<Slab> coarse;
+    for( unsigned int factor = settings_.MeshSequenceFactor(); factor > 1; factor /= 2 )
+    {
+        std::unique_ptr<Slab> slab( new Slab( settings, layout_.Coarsened( factor ), mirrored_ ) );
+        slab->stream_[ FORWARD ] = &null_out;
+        slab->stream_[ ADJOINT ] = &null_out;
+        auto start = std::chrono::steady_clock::now();
+        if( coarse )
+        {
+            slab->ProlongFrom<FORWARD>( *coarse );
+        }
+        slab->SolveEigenvalue<FORWARD>( coarse != nullptr );
+        const double solve_time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+        std::cout << "Coarsening factor: " << factor << "\t";
+        std::cout << "Cells: " << slab->NumCells() << "\t";
+        std::cout << "k eigenvalue: " << slab->KEigenvalue() << "\t";
+        std::cout << "Sweeps: " << slab->NumSweeps() << "\t";
+        std::cout << "Solve time (s): " << solve_time << std::endl;
+        coarse = std::move( slab );
+    }
+    if( coarse )
+    {
+        ProlongFrom<FORWARD>( *coarse );
+    }
+    SolveEigenvalue<FORWARD>( coarse != nullptr );
+}
+
+// Solve for k eigenvalue by Jacobian free Newton Krylov
+void Slab::JfnkEigenvalueSolve()
+{
+    SolveJfnkEigenvalue<FORWARD>();
 }
 
 // Solve for fission source matrix
 void Slab::FissionMatrixSolve()
 {
+    profile_[ FORWARD ]->Reset();
     std::vector<std::vector<double>> fiss_matrix;
     for( auto j_it = cells_.begin(); j_it != cells_.end(); j_it++ )
     {
@@ -83,34 +377,38 @@ void Slab::FissionMatrixSolve()
         std::for_each( cells_.begin(), cells_.end(),
                 [this]( Cell &c )
                 {
-                    c.SetExternalSource( GroupDependent( energy_groups_, 0.0 ) );
+                    c.SetExternalSource<FORWARD>( GroupDependent( energy_groups_, 0.0 ) );
                 } );
         // External source is divided by cell width to ensure "one" source
         // neutron is produced
-        j_it->SetExternalSource( j_it->MaterialReference().FissChi() / j_it->Width() );
-        cur_k_ = std::numeric_limits<double>::max();
-        FixedSourceSolve();
+        j_it->SetExternalSource<FORWARD>( j_it->MaterialReference().FissChi() / j_it->Width() );
+        cur_k_[ FORWARD ] = std::numeric_limits<double>::max();
+        FixedSourceSolve<FORWARD>();
         // Calculate number of neutrons produced in each cell
         for( auto i_it = cells_.begin(); i_it != cells_.end(); i_it++ )
         {
             fiss_matrix.back().push_back(
-                    Dot( i_it->MidpointAngularFluxReference().ScalarFluxReference(),
+                    Dot( i_it->ScalarFlux<FORWARD>(),
                         i_it->MaterialReference().FissNu() *
                         i_it->MaterialReference().MacroFissXsec() ) *
                     i_it->Width() );
         }
     }
     // Print fiss_matrix
-    std::cout << "#fission_matrix" << std::endl;
-    for( auto j_it = fiss_matrix.begin() ; j_it != fiss_matrix.end(); j_it++ )
     {
-        for( auto i_it = j_it->begin(); i_it != j_it->end(); i_it++ )
+        Profile::ScopedTimer timer( *profile_[ FORWARD ], Profile::OUTPUT );
+        std::cout << "#fission_matrix" << std::endl;
+        for( auto j_it = fiss_matrix.begin() ; j_it != fiss_matrix.end(); j_it++ )
         {
-            std::cout << *i_it;
-            i_it == prev( j_it->end() ) ? std::cout << std::endl : std::cout << ",";
+            for( auto i_it = j_it->begin(); i_it != j_it->end(); i_it++ )
+            {
+                std::cout << *i_it;
+                i_it == prev( j_it->end() ) ? std::cout << std::endl : std::cout << ",";
+            }
         }
+        std::cout << "#end" << std::endl;
     }
-    std::cout << "#end" << std::endl;
+    profile_[ FORWARD ]->Print( std::cout, "fission matrix" );
 }
 
 // Solve for first generation weighted source (FGWS)
@@ -118,12 +416,14 @@ void Slab::FirstGenerationWeightedSourceSolve()
 {
     // Solve the forward problem
     EigenvalueSolve();
-    adj_cur_k_ = std::numeric_limits<double>::max();
+    ReconstructAngularFluxes<FORWARD>();
+    profile_[ ADJOINT ]->Reset();
+    cur_k_[ ADJOINT ] = std::numeric_limits<double>::max();
     // Set all cells external source (response) to zero
     std::for_each( cells_.begin(), cells_.end(),
             [this]( Cell &c )
             {
-                c.AdjSetExternalSource( GroupDependent( energy_groups_, 0.0 ) );
+                c.SetExternalSource<ADJOINT>( GroupDependent( energy_groups_, 0.0 ) );
             } );
     // Solve fixed source problem for each cell
     std::vector<double> result;
@@ -138,87 +438,556 @@ void Slab::FirstGenerationWeightedSourceSolve()
         if( response.GroupSum() != 0.0 )
         {
             // Set response of current cell
-            out_it->AdjSetExternalSource( response );
+            out_it->SetExternalSource<ADJOINT>( response );
             // Solve fixed source problem
-            AdjFixedSourceSolve();
+            FixedSourceSolve<ADJOINT>();
+            ReconstructAngularFluxes<ADJOINT>();
             // Calculate inner product of forward k-eigenvalue solution and adjoint
             // fixed source solution
             for( auto in_it = cells_.begin(); in_it != cells_.end(); in_it++ )
             {
-                AngularFlux AdjWeightedAngularFlux = in_it->MidpointAngularFluxReference();
-                AdjWeightedAngularFlux.WeightBy( in_it->AdjMidpointAngularFluxReference() );
-                GroupDependent AdjWeightedScalarFlux = AdjWeightedAngularFlux.ScalarFluxReference() / speeds_;
+                AngularFlux AdjWeightedAngularFlux = in_it->MidpointAngularFluxReference<FORWARD>();
+                AdjWeightedAngularFlux.WeightBy( in_it->MidpointAngularFluxReference<ADJOINT>() );
+                GroupDependent AdjWeightedScalarFlux = AdjWeightedAngularFlux.ScalarFlux() / speeds_;
                 result.back() += AdjWeightedScalarFlux.GroupSum();
             }
         }
         // Unset response of current cell to fission cross section
-        out_it->AdjSetExternalSource( GroupDependent( energy_groups_, 0.0 ) );
+        out_it->SetExternalSource<ADJOINT>( GroupDependent( energy_groups_, 0.0 ) );
     }
+    ReleaseAngularFluxes<FORWARD>();
+    ReleaseAngularFluxes<ADJOINT>();
     // Print results
-    std::cout << "#first_generation_weighted_source" << std::endl;
-    for( auto it = result.begin(); it != result.end(); it++ )
     {
-        std::cout << *it;
-        it == std::prev( result.end() ) ? std::cout << std::endl : std::cout << ",";
+        Profile::ScopedTimer timer( *profile_[ ADJOINT ], Profile::OUTPUT );
+        std::cout << "#first_generation_weighted_source" << std::endl;
+        for( auto it = result.begin(); it != result.end(); it++ )
+        {
+            std::cout << *it;
+            it == std::prev( result.end() ) ? std::cout << std::endl : std::cout << ",";
+        }
+        std::cout << "#end" << std::endl;
     }
-    std::cout << "#end" << std::endl;
+    profile_[ ADJOINT ]->Print( std::cout, "first generation weighted source" );
 }
 
 // Solve for the fission source
 void Slab::FissionSourceSolve()
 {
     std::cout << "#fission_source" << std::endl;
-    for( auto it = cells_.begin(); it != cells_.end(); it++ )
+    for( std::size_t i = 0; i != NumOutputCells(); i++ )
     {
-        std::cout << Dot( it->MaterialReference().FissNu() * it->MaterialReference().MacroFissXsec(),
-                it->MidpointAngularFluxReference().ScalarFluxReference() );
-        it == std::prev( cells_.end() ) ? std::cout << std::endl : std::cout << ",";
+        Cell &cell = OutputCell( i );
+        std::cout << Dot( cell.MaterialReference().FissNu() * cell.MaterialReference().MacroFissXsec(),
+                cell.ScalarFlux<FORWARD>() );
+        i + 1 == NumOutputCells() ? std::cout << std::endl : std::cout << ",";
     }
     std::cout << "#end" << std::endl;
 }
 
+// Print memory used per cell and by the shared materials
+void Slab::MemoryReport()
+{
+    const double bytes_per_cell = double( MemoryUsage() ) / cells_.size();
+    std::cout << "Angular flux storage: " << ( settings_.AngularFluxStorage() == Settings::EDGE ? "edge" : "full" ) << "\t";
+    std::cout << "Angular flux precision: " << ( settings_.AngularFluxPrecision() == Settings::FLOAT ? "float" : "double" ) << std::endl;
+    std::cout << "Cells: " << cells_.size() << "\t";
+    std::cout << "Bytes per cell: " << bytes_per_cell << std::endl;
+    std::cout << "Cell storage (MB): " << MemoryUsage() / 1.0e6 << "\t";
+    std::cout << "Shared material storage (bytes): " << layout_.MaterialMemoryUsage() << std::endl;
+    std::cout << "Projected cell storage for 1000000 cells (MB): " << bytes_per_cell << std::endl;
+}
+
+// Solve the k eigenvalue problem with angular fluxes stored in double and in
+// single precision and print the differences
+void Slab::PrecisionReport()
+{
+    Settings settings[2] = { settings_, settings_ };
+    settings[0].SetAngularFluxPrecision( Settings::DOUBLE );
+    settings[1].SetAngularFluxPrecision( Settings::FLOAT );
+    const char *names[2] = { "double", "float" };
+    std::vector<std::vector<double>> scl_fluxes( 2 );
+    double k[2];
+    for( unsigned int p = 0; p != 2; p++ )
+    {
+        // Progress and results of the solves are discarded
+        std::ostream null_out( nullptr );
+        Slab slab( settings[ p ], layout_ );
+        slab.stream_[ FORWARD ] = &null_out;
+        slab.stream_[ ADJOINT ] = &null_out;
+        auto start = std::chrono::steady_clock::now();
+        slab.EigenvalueSolve();
+        const double solve_time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+        k[ p ] = slab.KEigenvalue();
+        for( auto cell_it = slab.cells_.begin(); cell_it != slab.cells_.end(); cell_it++ )
+        {
+            const std::vector<double> &values = cell_it->ScalarFluxValues<FORWARD>();
+            scl_fluxes[ p ].insert( scl_fluxes[ p ].end(), values.begin(), values.end() );
+        }
+        std::cout << "Angular flux precision: " << names[ p ] << "\t";
+        std::cout << "k eigenvalue: " << k[ p ] << "\t";
+        std::cout << "Sweeps: " << slab.NumSweeps() << "\t";
+        std::cout << "Bytes per cell: " << double( slab.MemoryUsage() ) / slab.NumCells() << "\t";
+        std::cout << "Solve time (s): " << solve_time << std::endl;
+    }
+
+    // Scalar fluxes are compared group by group relative to the double
+    // precision solution
+    std::cout << "k difference (pcm): " << 1.0e5 * std::fabs( k[1] - k[0] ) << std::endl;
+    const std::size_t num_groups = energy_groups_.size();
+    std::size_t g = 0;
+    for( auto energy_it = energy_groups_.begin(); energy_it != energy_groups_.end(); energy_it++, g++ )
+    {
+        double max_error = 0.0;
+        double sum_squares = 0.0;
+        for( std::size_t i = g; i < scl_fluxes[0].size(); i += num_groups )
+        {
+            const double error = std::fabs( scl_fluxes[1][ i ] - scl_fluxes[0][ i ] ) / std::fabs( scl_fluxes[0][ i ] );
+            max_error = std::max( max_error, error );
+            sum_squares += error * error;
+        }
+        std::cout << "Energy group: " << *energy_it << "\t";
+        std::cout << "Max relative scalar flux difference: " << max_error << "\t";
+        std::cout << "RMS relative scalar flux difference: " << std::sqrt( sum_squares / cells_.size() ) << std::endl;
+    }
+}
+
+// Return memory used by cells (bytes)
+std::size_t Slab::MemoryUsage() const
+{
+    const std::size_t correction = correction_ ? correction_->MemoryUsage() : 0;
+    return correction + std::accumulate( cells_.begin(), cells_.end(), std::size_t( 0 ),
+            []( std::size_t bytes, const Cell &c )
+            {
+                return bytes + c.MemoryUsage();
+            } );
+}
+
+// Solve for k eigenvalue
+template<Sense S>
+void Slab::SolveEigenvalue( bool warm_start )
+{
+    profile_[ S ]->Reset();
+    if( !anderson_.empty() )
+    {
+        anderson_[ S ].Reset();
+    }
+    // A guess consistent with its k would pass the first k check without a
+    // sweep, so at least one outer iteration is forced after it
+    bool force_outer = warm_start || DiffusionGuess<S>();
+    // Iterate while k is not converged, or the last inner iterations stopped
+    // short of the scalar flux tolerance
+    double inner_tol = settings_.SclFluxTol();
+    while( !KConverged<S>() || force_outer || inner_tol > settings_.SclFluxTol() )
+    {
+        force_outer = false;
+        profile_[ S ]->CountOuter();
+        inner_tol = InnerTolerance<S>();
+        // Iterate while scalar flux is not converged
+        unsigned int i = 0;
+        do
+        {
+            i++;
+            profile_[ S ]->CountInner();
+            UpdateScatterSources<S>();
+            TransportSweep<S>();
+            Accelerate<S>();
+        } while( !ScalarFluxConverged<S>( i, inner_tol ) );
+    }
+    PrintScalarFluxes<S>();
+    profile_[ S ]->Print( *stream_[ S ], S == FORWARD ? "k eigenvalue" : "adjoint k eigenvalue" );
+}
+
+// Replace the flat guesses of sense S with the diffusion solution
+template<Sense S>
+bool Slab::DiffusionGuess()
+{
+    if( !settings_.DiffusionGuess() || num_sweeps_[ S ] != 0 )
+    {
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    Diffusion diffusion( layout_, settings_ );
+    if( !diffusion.Solve<S>( cur_k_[ S ] ) )
+    {
+        return false;
+    }
+    // The flux is scaled to produce the fission source guess
+    const unsigned int num_groups = energy_groups_.size();
+    const std::vector<double> &scl_flux = diffusion.ScalarFlux();
+    std::vector<double> guess( num_groups );
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        for( unsigned int g = 0; g != num_groups; g++ )
+        {
+            guess[ g ] = cur_fission_source_[ S ] * scl_flux[ i * num_groups + g ];
+        }
+        cells_[ i ].SetScalarFlux<S>( guess.data() );
+    }
+    cur_k_[ S ] = diffusion.KEigenvalue();
+    ResetFissionSource<S>();
+    const double solve_time = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::OUTPUT );
+    *stream_[ S ] << ( S == FORWARD ? "Diffusion k guess: " : "Diffusion adjoint k guess: " );
+    *stream_[ S ] << cur_k_[ S ] << "\tIterations: " << diffusion.NumIterations() << "\t";
+    *stream_[ S ] << "Solve time (s): " << solve_time << std::endl;
+    return true;
+}
+
+// Replace the flux of sense S with the projected midpoint angular flux of a
+// coarser slab
+template<Sense S>
+void Slab::ProlongFrom( Slab &coarse )
+{
+    const std::size_t size = mid_angflux_[ S ].Size();
+    std::vector<double> values( coarse.cells_.size() * size );
+    coarse.ReconstructAngularFluxes<S>();
+    for( std::size_t i = 0; i != coarse.cells_.size(); i++ )
+    {
+        coarse.cells_[ i ].MidpointAngularFluxReference<S>().Values( &values[ i * size ] );
+    }
+    coarse.ReleaseAngularFluxes<S>();
+    // Every group and ordinate is averaged over the overlap of coarse and fine
+    // cells
+    const std::vector<double> projected = AdaptiveMesh::Project( values, size, coarse.layout_.CellWidths(),
+            layout_.CellWidths() );
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        mid_angflux_[ S ].SetValues( &projected[ i * size ] );
+        cells_[ i ].SetAngularFlux<S>( mid_angflux_[ S ] );
+    }
+    cur_k_[ S ] = coarse.cur_k_[ S ];
+    ResetFissionSource<S>();
+}
+
+// Recompute the fission source of sense S from the current flux and k
+template<Sense S>
+void Slab::ResetFissionSource()
+{
+    UpdateFissionSources<S>();
+    cur_fission_source_[ S ] = TotalFissionSource<S>();
+}
+
 // Solve for fixed source
+template<Sense S>
 void Slab::FixedSourceSolve()
 {
+    // Each fixed source solve is counted as one outer iteration
+    profile_[ S ]->CountOuter();
     unsigned int i = 0;
     do
     {
         i++;
-        UpdateScatterSources();
-        UpdateFissionSources();
-        ImposeLeftBC();
-        SweepRight();
-        cells_.back().RightReflectBoundary();
-        SweepLeft();
-    } while( !ScalarFluxConverged( i ) );
+        profile_[ S ]->CountInner();
+        UpdateScatterSources<S>();
+        UpdateFissionSources<S>();
+        TransportSweep<S>();
+        Accelerate<S>();
+    } while( !ScalarFluxConverged<S>( i, settings_.SclFluxTol() ) );
 }
 
-// [Adjoint] Solve for fixed source
-void Slab::AdjFixedSourceSolve()
+// Solve for k eigenvalue by Jacobian free Newton Krylov
+template<Sense S>
+void Slab::SolveJfnkEigenvalue()
 {
-    unsigned int i = 0;
-    do
+    profile_[ S ]->Reset();
+    // Newton's method converges to the eigenpair nearest its start, so
+    // without a diffusion guess power iterations to a loose tolerance first
+    // bring the flux near the fundamental mode
+    const double start_tol = 1.0e-3;
+    if( !DiffusionGuess<S>() )
     {
-        i++;
-        AdjUpdateScatterSources();
-        AdjUpdateFissionSources();
-        AdjImposeLeftBC();
-        AdjSweepRight();
-        cells_.back().AdjRightReflectBoundary();
-        AdjSweepLeft();
-    } while( !AdjScalarFluxConverged( i ) );
+        while( !KConverged<S>() && std::fabs( cur_k_[ S ] - prev_k_[ S ] ) >= start_tol * prev_k_[ S ] )
+        {
+            profile_[ S ]->CountOuter();
+            unsigned int i = 0;
+            do
+            {
+                i++;
+                profile_[ S ]->CountInner();
+                UpdateScatterSources<S>();
+                TransportSweep<S>();
+                Accelerate<S>();
+            } while( !ScalarFluxConverged<S>( i, start_tol ) );
+        }
+    }
+    const unsigned int num_groups = energy_groups_.size();
+    const std::size_t num_fluxes = cells_.size() * num_groups;
+    const std::size_t size = num_fluxes + 1;
+
+    // The scalar flux is scaled to a unit norm so that the flux and k
+    // residuals weigh alike in the Krylov solves, and held to the fission
+    // production of the guess
+    std::vector<double> x( size );
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        const std::vector<double> &values = cells_[ i ].ScalarFluxValues<S>();
+        std::copy( values.begin(), values.end(), x.begin() + i * num_groups );
+    }
+    const double flux_scale = Norm( x, num_fluxes );
+    for( std::size_t n = 0; n != num_fluxes; n++ )
+    {
+        x[ n ] /= flux_scale;
+    }
+    x.back() = cur_k_[ S ];
+    ResetFissionSource<S>();
+    const double production = cur_k_[ S ] * cur_fission_source_[ S ];
+
+    Diffusion diffusion( layout_, settings_ );
+    Gmres gmres( size, settings_.KrylovSize() );
+    std::vector<double> residual( size );
+    std::vector<double> step( size );
+    std::vector<double> direction( size );
+    std::vector<double> trial( size );
+    std::vector<double> trial_residual( size );
+    std::vector<double> source( num_fluxes );
+    NewtonResidual<S>( x, flux_scale, production, residual );
+    double residual_norm = Norm( residual, size );
+
+    // Each Newton step is solved to a residual of forcing times that of the
+    // Newton residual, the forcing following the Eisenstat-Walker choice 2 so
+    // that early steps are solved loosely
+    const double max_forcing = 0.1;
+    double forcing = max_forcing;
+    // Perturbations for differencing are the square root of the precision
+    // the angular fluxes are stored to
+    const double perturbation = std::sqrt( settings_.AngularFluxPrecision() == Settings::FLOAT ?
+            std::numeric_limits<float>::epsilon() : std::numeric_limits<double>::epsilon() );
+    const unsigned int max_backtracks = 4;
+    // Converged once the k change of a Newton step and the largest residual
+    // of a scalar flux value relative to the largest value of its group are
+    // within tolerance
+    double k_error = 1.0;
+    double flux_error = MaxRelativeResidual( residual, x, cells_.size(), num_groups );
+    while( k_error >= settings_.KTol() || flux_error >= settings_.SclFluxTol() )
+    {
+        profile_[ S ]->CountOuter();
+        // The Newton step solves J M^-1 u = -F for M^-1 u, M^-1 being the
+        // diffusion preconditioner and J v differenced from the residual of a
+        // perturbed x
+        for( std::size_t n = 0; n != size; n++ )
+        {
+            step[ n ] = -residual[ n ];
+        }
+        {
+            Profile::ScopedTimer timer( *profile_[ S ], Profile::ACCELERATION );
+            gmres.Start( step, forcing );
+        }
+        while( gmres.Continue() )
+        {
+            profile_[ S ]->CountInner();
+            const std::vector<double> &basis = gmres.Direction();
+            std::copy( basis.begin(), basis.end(), direction.begin() );
+            DiffusionPrecondition<S>( diffusion, source, direction );
+            const double epsilon = perturbation * ( 1.0 + Norm( x, size ) ) / Norm( direction, size );
+            for( std::size_t n = 0; n != size; n++ )
+            {
+                trial[ n ] = x[ n ] + epsilon * direction[ n ];
+            }
+            NewtonResidual<S>( trial, flux_scale, production, trial_residual );
+            for( std::size_t n = 0; n != size; n++ )
+            {
+                trial_residual[ n ] = ( trial_residual[ n ] - residual[ n ] ) / epsilon;
+            }
+            Profile::ScopedTimer timer( *profile_[ S ], Profile::ACCELERATION );
+            gmres.Extend( trial_residual );
+        }
+        {
+            Profile::ScopedTimer timer( *profile_[ S ], Profile::ACCELERATION );
+            gmres.Solution( step );
+        }
+        DiffusionPrecondition<S>( diffusion, source, step );
+
+        // Halve the step until it reduces the residual norm, taking the last
+        // halving regardless. The cells are left holding the sweep of the new
+        // x.
+        double trial_norm = residual_norm;
+        double fraction = 1.0;
+        for( unsigned int backtrack = 0; ; backtrack++ )
+        {
+            for( std::size_t n = 0; n != size; n++ )
+            {
+                trial[ n ] = x[ n ] + fraction * step[ n ];
+            }
+            NewtonResidual<S>( trial, flux_scale, production, trial_residual );
+            trial_norm = Norm( trial_residual, size );
+            if( trial_norm <= ( 1.0 - 1.0e-4 * fraction ) * residual_norm || backtrack == max_backtracks )
+            {
+                break;
+            }
+            fraction *= 0.5;
+        }
+        k_error = std::fabs( ( trial.back() - x.back() ) / x.back() );
+        x.swap( trial );
+        residual.swap( trial_residual );
+        const double prev_forcing = forcing;
+        forcing = 0.9 * ( trial_norm / residual_norm ) * ( trial_norm / residual_norm );
+        if( 0.9 * prev_forcing * prev_forcing > 0.1 )
+        {
+            forcing = std::max( forcing, 0.9 * prev_forcing * prev_forcing );
+        }
+        forcing = std::min( forcing, max_forcing );
+        residual_norm = trial_norm;
+        flux_error = MaxRelativeResidual( residual, x, cells_.size(), num_groups );
+
+        Profile::ScopedTimer timer( *profile_[ S ], Profile::OUTPUT );
+        *stream_[ S ] << ( S == FORWARD ? "k eigenvalue: " : "adjoint k eigenvalue: " ) << cur_k_[ S ];
+        *stream_[ S ] << "\tRelative error: " << k_error << "\tFlux residual: " << flux_error;
+        *stream_[ S ] << "\tKrylov iterations: " << gmres.NumIterations() << "\tStep fraction: " << fraction << std::endl;
+    }
+    PrintScalarFluxes<S>();
+    profile_[ S ]->Print( *stream_[ S ], S == FORWARD ? "jfnk k eigenvalue" : "jfnk adjoint k eigenvalue" );
+}
+
+// Write the Newton residual of x
+template<Sense S>
+void Slab::NewtonResidual( const std::vector<double> &x, double flux_scale, double production,
+        std::vector<double> &residual )
+{
+    const unsigned int num_groups = energy_groups_.size();
+    std::vector<double> &scl_flux = cell_sclflux_[ S ];
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        for( unsigned int g = 0; g != num_groups; g++ )
+        {
+            scl_flux[ g ] = flux_scale * x[ i * num_groups + g ];
+        }
+        cells_[ i ].SetScalarFlux<S>( scl_flux.data() );
+    }
+    cur_k_[ S ] = x.back();
+    UpdateScatterSources<S>();
+    ResetFissionSource<S>();
+    TransportSweep<S>();
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        const std::vector<double> &values = cells_[ i ].ScalarFluxValues<S>();
+        for( unsigned int g = 0; g != num_groups; g++ )
+        {
+            residual[ i * num_groups + g ] = x[ i * num_groups + g ] - values[ g ] / flux_scale;
+        }
+    }
+    residual.back() = 1.0 - cur_k_[ S ] * cur_fission_source_[ S ] / production;
+}
+
+// Add the diffusion estimate of the error a sweep would leave to the flux of x
+template<Sense S>
+void Slab::DiffusionPrecondition( Diffusion &diffusion, std::vector<double> &source, std::vector<double> &x )
+{
+    // The error of a sweep from flux x obeys the transport equation with the
+    // scattering source of x, as in angular multigrid below the lowest order
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::ACCELERATION );
+    const unsigned int num_groups = energy_groups_.size();
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        cells_[ i ].ScatteringSource<S>( &x[ i * num_groups ], &source[ i * num_groups ] );
+    }
+    diffusion.SolveFixedSource<S>( source );
+    const std::vector<double> &error = diffusion.ScalarFlux();
+    for( std::size_t n = 0; n != source.size(); n++ )
+    {
+        x[ n ] += error[ n ];
+    }
+}
+
+// Sweep all cells right from the left boundary, impose the right boundary
+// condition and sweep all cells back left
+template<Sense S>
+void Slab::TransportSweep()
+{
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::SWEEP );
+    if( settings_.AngularFluxStorage() == Settings::EDGE )
+    {
+        ImposeEdgeLeftBC<S>();
+        EdgeSweep<S,RIGHT>();
+        ImposeEdgeRightBC<S>();
+        EdgeSweep<S,LEFT>();
+    }
+    else
+    {
+        ImposeLeftBC<S>();
+        Sweep<S,RIGHT>();
+        ImposeRightBC<S>();
+        Sweep<S,LEFT>();
+    }
+    num_sweeps_[ S ]++;
+    profile_[ S ]->CountSweeps( 1 );
+}
+
+// Correct the scalar flux after a sweep with the error estimated on the next
+// lower order quadrature or by diffusion
+template<Sense S>
+unsigned long Slab::Accelerate()
+{
+    if( settings_.InnerAcceleration() != Settings::ANGULAR_MULTIGRID )
+    {
+        return 0;
+    }
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::ACCELERATION );
+    // The error left by a sweep obeys the transport equation with the
+    // scattering source of the change the sweep made. Only its isotropic part
+    // is estimated and added back.
+    const unsigned int num_groups = energy_groups_.size();
+    std::vector<double> &source = error_source_[ S ];
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        cells_[ i ].ScatteringSourceChange<S>( &source[ i * num_groups ] );
+    }
+    unsigned long sweeps = 0;
+    if( correction_ )
+    {
+        Slab &correction = *correction_;
+        for( std::size_t i = 0; i != cells_.size(); i++ )
+        {
+            correction.cells_[ i ].SetExternalSource<S>( &source[ i * num_groups ] );
+        }
+        sweeps = correction.SolveCorrection<S>();
+        for( std::size_t i = 0; i != cells_.size(); i++ )
+        {
+            cells_[ i ].AddScalarFlux<S>( correction.cells_[ i ].ScalarFluxValues<S>().data() );
+        }
+    }
+    else
+    {
+        Diffusion &diffusion = diffusion_[ S ];
+        diffusion.SolveFixedSource<S>( source );
+        const std::vector<double> &error = diffusion.ScalarFlux();
+        for( std::size_t i = 0; i != cells_.size(); i++ )
+        {
+            cells_[ i ].AddScalarFlux<S>( &error[ i * num_groups ] );
+        }
+    }
+    profile_[ S ]->CountLowOrderSweeps( sweeps );
+    num_low_order_sweeps_[ S ] += sweeps;
+    return sweeps;
+}
+
+// Estimate the scalar flux error of a higher order sweep
+template<Sense S>
+unsigned long Slab::SolveCorrection()
+{
+    // The error is swept once from zero and corrected by the levels below, a
+    // V cycle. The scattering and fission sources of a zero flux are zero, and
+    // since they are never updated they stay so. Only the flux a reflecting
+    // left boundary turns around has to be zeroed.
+    std::vector<double> &zero = cell_sclflux_[ S ];
+    std::fill( zero.begin(), zero.end(), 0.0 );
+    cells_.front().SetScalarFlux<S>( zero.data() );
+    edge_angflux_[ S ].SetIsotropic( zero.data() );
+    TransportSweep<S>();
+    return 1 + Accelerate<S>();
 }
 
 // Impose left boundary condition
+template<Sense S>
 void Slab::ImposeLeftBC()
 {
     if( settings_.LeftBC() == Settings::VACUUM )
     {
-        cells_.front().LeftVacuumBoundary();
+        cells_.front().LeftVacuumBoundary<S>( bnd_angflux_[ S ], sweep_kernels_ );
     }
     else if( settings_.LeftBC() == Settings::REFLECTING )
     {
-        cells_.front().LeftReflectBoundary();
+        cells_.front().LeftReflectBoundary<S>( bnd_angflux_[ S ], sweep_kernels_ );
     }
     else
     {
@@ -226,308 +995,453 @@ void Slab::ImposeLeftBC()
     }
 }
 
-// [Adjoint] Impose left boundary condition
-void Slab::AdjImposeLeftBC()
+// Impose left boundary condition on the edge flux. The incoming flux is kept
+// in the boundary flux for reconstructing angular fluxes.
+template<Sense S>
+void Slab::ImposeEdgeLeftBC()
 {
+    // After the previous sweep the edge flux leaves the left boundary
+    AngularFlux &bnd_angflux = bnd_angflux_[ S ];
     if( settings_.LeftBC() == Settings::VACUUM )
     {
-        cells_.front().AdjLeftVacuumBoundary();
+        bnd_angflux.ZeroOrdinates( SweepPolicy<S,RIGHT>::positive );
     }
     else if( settings_.LeftBC() == Settings::REFLECTING )
     {
-        cells_.front().AdjLeftReflectBoundary();
+        bnd_angflux.CopyValues( edge_angflux_[ S ] );
+        bnd_angflux.ReflectOrdinates( SweepPolicy<S,RIGHT>::positive );
     }
     else
     {
         assert( false );
     }
+    edge_angflux_[ S ].CopyValues( bnd_angflux );
 }
 
-// Sweep right
-void Slab::SweepRight()
+// Impose right boundary condition
+template<Sense S>
+void Slab::ImposeRightBC()
 {
-    for( auto cell_it = std::next( cells_.begin() ); cell_it != cells_.end(); cell_it++ )
+    if( settings_.RightBC() == Settings::VACUUM )
+    {
+        cells_.back().RightVacuumBoundary<S>( bnd_angflux_[ S ], sweep_kernels_ );
+    }
+    else if( settings_.RightBC() == Settings::REFLECTING )
     {
-        cell_it->SweepRight( std::prev( cell_it )->OutgoingAngularFluxReference() );
+        cells_.back().RightReflectBoundary<S>( bnd_angflux_[ S ], sweep_kernels_ );
+    }
+    else
+    {
+        assert( false );
     }
 }
 
-// [Adjoint] Sweep right
-void Slab::AdjSweepRight()
+// Impose right boundary condition on the edge flux, which leaves the right
+// boundary after a sweep to the right and is turned around in place
+template<Sense S>
+void Slab::ImposeEdgeRightBC()
 {
-    for( auto cell_it = std::next( cells_.begin() ); cell_it != cells_.end(); cell_it++ )
+    RightBoundaryFlux<S>( edge_angflux_[ S ] );
+}
+
+// Impose right boundary condition on an angular flux leaving the right boundary
+template<Sense S>
+void Slab::RightBoundaryFlux( AngularFlux &angflux ) const
+{
+    if( settings_.RightBC() == Settings::VACUUM )
+    {
+        angflux.ZeroOrdinates( SweepPolicy<S,LEFT>::positive );
+    }
+    else if( settings_.RightBC() == Settings::REFLECTING )
     {
-        cell_it->AdjSweepRight( std::prev( cell_it )->AdjOutgoingAngularFluxReference() );
+        angflux.ReflectOrdinates( SweepPolicy<S,LEFT>::positive );
+    }
+    else
+    {
+        assert( false );
     }
 }
 
-// Sweep left
-void Slab::SweepLeft()
+// Sweep the edge flux through all cells in direction D
+template<Sense S, Direction D>
+void Slab::EdgeSweep()
 {
-    for( auto cell_it = std::next( cells_.rbegin() ); cell_it != cells_.rend(); cell_it++ )
+    if( D == RIGHT )
     {
-        cell_it->SweepLeft( std::prev( cell_it )->OutgoingAngularFluxReference() );
+        for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
+        {
+            cell_it->EdgeSweep<S,D>( edge_angflux_[ S ], mid_angflux_[ S ], sweep_kernels_ );
+        }
+    }
+    else
+    {
+        for( auto cell_it = cells_.rbegin(); cell_it != cells_.rend(); cell_it++ )
+        {
+            cell_it->EdgeSweep<S,D>( edge_angflux_[ S ], mid_angflux_[ S ], sweep_kernels_ );
+        }
     }
 }
 
-// [Adjoint] Sweep left
-void Slab::AdjSweepLeft()
+// Sweep forward and adjoint edge fluxes through all cells in direction D in a
+// single pass
+template<Direction D>
+void Slab::EdgeFusedSweep()
 {
-    for( auto cell_it = std::next( cells_.rbegin() ); cell_it != cells_.rend(); cell_it++ )
+    if( D == RIGHT )
     {
-        cell_it->AdjSweepLeft( std::prev( cell_it )->AdjOutgoingAngularFluxReference() );
+        for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
+        {
+            cell_it->EdgeFusedSweep<D>( edge_angflux_[ FORWARD ], mid_angflux_[ FORWARD ], edge_angflux_[ ADJOINT ],
+                    mid_angflux_[ ADJOINT ], sweep_kernels_ );
+        }
+    }
+    else
+    {
+        for( auto cell_it = cells_.rbegin(); cell_it != cells_.rend(); cell_it++ )
+        {
+            cell_it->EdgeFusedSweep<D>( edge_angflux_[ FORWARD ], mid_angflux_[ FORWARD ], edge_angflux_[ ADJOINT ],
+                    mid_angflux_[ ADJOINT ], sweep_kernels_ );
+        }
     }
 }
 
-// Check if k eigenvalue is converged. If not, create new fission source.
-bool Slab::KConverged()
+// Rebuild the midpoint and outgoing angular fluxes of all cells if only edge
+// fluxes are stored
+template<Sense S>
+void Slab::ReconstructAngularFluxes()
 {
-    // Update the fission source in all cells
-    std::for_each( cells_.begin(), cells_.end(),
-            []( Cell &c )
-            {
-                c.UpdateMidpointFissionSource();
-            } );
-
-    prev_fission_source_ = cur_fission_source_;
-    cur_fission_source_ = std::accumulate( cells_.begin(), cells_.end(), 0.0,
-            []( const double &x, Cell &c )
-            {
-                return x + c.FissionSource();
-            } );
+    if( settings_.AngularFluxStorage() != Settings::EDGE )
+    {
+        return;
+    }
+    // Repeat the last transport sweep from its incoming boundary flux, which
+    // reproduces the angular fluxes it computed
+    for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
+    {
+        cell_it->AllocateAngularFluxes<S>();
+    }
+    cells_.front().Resweep<S,RIGHT>( bnd_angflux_[ S ], sweep_kernels_ );
+    for( auto cell_it = std::next( cells_.begin() ); cell_it != cells_.end(); cell_it++ )
+    {
+        cell_it->Resweep<S,RIGHT>( std::prev( cell_it )->OutgoingAngularFluxReference<S>(), sweep_kernels_ );
+    }
+    AngularFlux &right_angflux = mid_angflux_[ S ];
+    right_angflux.CopyValues( cells_.back().OutgoingAngularFluxReference<S>() );
+    RightBoundaryFlux<S>( right_angflux );
+    cells_.back().Resweep<S,LEFT>( right_angflux, sweep_kernels_ );
+    for( auto cell_it = std::next( cells_.rbegin() ); cell_it != cells_.rend(); cell_it++ )
+    {
+        cell_it->Resweep<S,LEFT>( std::prev( cell_it )->OutgoingAngularFluxReference<S>(), sweep_kernels_ );
+    }
+}
 
-    prev_k_ = cur_k_;
-    cur_k_ = prev_k_ * cur_fission_source_ / prev_fission_source_;
+// Free angular fluxes rebuilt by ReconstructAngularFluxes()
+template<Sense S>
+void Slab::ReleaseAngularFluxes()
+{
+    for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
+    {
+        cell_it->ReleaseAngularFluxes<S>();
+    }
+}
 
-    double k_error =  std::fabs( ( cur_k_ - prev_k_ ) / prev_k_ );
-    std::cout << "k eigenvalue: " << cur_k_ << "\tRelative error: " << k_error << std::endl;
+// Sweep through cells in direction D. The boundary cell the sweep starts from
+// has already been swept by the boundary condition.
+template<Sense S, Direction D>
+void Slab::Sweep()
+{
+    if( D == RIGHT )
+    {
+        for( auto cell_it = std::next( cells_.begin() ); cell_it != cells_.end(); cell_it++ )
+        {
+            cell_it->Sweep<S,D>( std::prev( cell_it )->OutgoingAngularFluxReference<S>(), sweep_kernels_ );
+        }
+    }
+    else
+    {
+        for( auto cell_it = std::next( cells_.rbegin() ); cell_it != cells_.rend(); cell_it++ )
+        {
+            cell_it->Sweep<S,D>( std::prev( cell_it )->OutgoingAngularFluxReference<S>(), sweep_kernels_ );
+        }
+    }
+}
 
-    // Return boolean
-    return k_error < settings_.KTol();
+// Sweep forward and adjoint through cells in direction D in a single pass
+template<Direction D>
+void Slab::FusedSweep()
+{
+    if( D == RIGHT )
+    {
+        for( auto cell_it = std::next( cells_.begin() ); cell_it != cells_.end(); cell_it++ )
+        {
+            cell_it->FusedSweep<D>( std::prev( cell_it )->OutgoingAngularFluxReference<FORWARD>(),
+                    std::prev( cell_it )->OutgoingAngularFluxReference<ADJOINT>(), sweep_kernels_ );
+        }
+    }
+    else
+    {
+        for( auto cell_it = std::next( cells_.rbegin() ); cell_it != cells_.rend(); cell_it++ )
+        {
+            cell_it->FusedSweep<D>( std::prev( cell_it )->OutgoingAngularFluxReference<FORWARD>(),
+                    std::prev( cell_it )->OutgoingAngularFluxReference<ADJOINT>(), sweep_kernels_ );
+        }
+    }
 }
 
-// [Adjoint] Check if k eigenvalue is converged. If not, create new fission source.
-bool Slab::AdjKConverged()
+// Check if k eigenvalue is converged. If not, create new fission source.
+template<Sense S>
+bool Slab::KConverged()
 {
     // Update the fission source in all cells
-    std::for_each( cells_.begin(), cells_.end(),
-            []( Cell &c )
-            {
-                c.AdjUpdateMidpointFissionSource();
-            } );
+    UpdateFissionSources<S>();
 
-    adj_prev_fission_source_ = adj_cur_fission_source_;
-    adj_cur_fission_source_ = std::accumulate( cells_.begin(), cells_.end(), 0.0,
-            []( const double &x, Cell &c )
-            {
-                return x + c.AdjFissionSource();
-            } );
+    double k_error;
+    {
+        Profile::ScopedTimer timer( *profile_[ S ], Profile::K_CONVERGENCE );
+        prev_fission_source_[ S ] = cur_fission_source_[ S ];
+        cur_fission_source_[ S ] = TotalFissionSource<S>();
 
-    adj_prev_k_ = adj_cur_k_;
-    adj_cur_k_ = adj_prev_k_ * adj_cur_fission_source_ / adj_prev_fission_source_;
+        prev_k_[ S ] = cur_k_[ S ];
+        cur_k_[ S ] = prev_k_[ S ] * cur_fission_source_[ S ] / prev_fission_source_[ S ];
 
-    double adj_k_error =  std::fabs( ( adj_cur_k_ - adj_prev_k_ ) / adj_prev_k_ );
-    std::cout << "adjoint k eigenvalue: " << adj_cur_k_ << "\tRelative error: " << adj_k_error << std::endl;
+        k_error =  std::fabs( ( cur_k_[ S ] - prev_k_[ S ] ) / prev_k_[ S ] );
+        if( settings_.AdaptiveInnerTol() )
+        {
+            outer_change_[ S ] = std::max( k_error, FissionSourceChange<S>() );
+        }
+    }
+    MixFissionSources<S>();
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::OUTPUT );
+    *stream_[ S ] << ( S == FORWARD ? "k eigenvalue: " : "adjoint k eigenvalue: " ) << cur_k_[ S ] << "\tRelative error: " << k_error;
+    if( settings_.AdaptiveInnerTol() )
+    {
+        *stream_[ S ] << "\tInner tolerance: " << InnerTolerance<S>();
+    }
+    *stream_[ S ] << std::endl;
 
     // Return boolean
-    return adj_k_error < settings_.KTol();
+    return k_error < settings_.KTol();
 }
 
-// Check if scalar flux is converged
-bool Slab::ScalarFluxConverged( unsigned int iteration )
+// Replace the cell fission sources with their Anderson mixture
+template<Sense S>
+void Slab::MixFissionSources()
 {
-    std::vector<Cell>::iterator max_it = std::max_element( cells_.begin(), cells_.end(),
-            []( Cell &smaller, Cell &bigger )
-            {
-                if( smaller.MaxAbsScalarFluxError() < bigger.MaxAbsScalarFluxError() )
-                {
-                    return true;
-                }
-                else
-                {
-                    return false;
-                }
-            } );
-    double max_abs_rel_error = std::fabs( max_it->MaxAbsScalarFluxError() );
-    double sum_sclflux = max_it->MidpointAngularFluxReference().ScalarFluxReference().GroupSum();
-    if( iteration % settings_.ProgressPeriod() == 0 )
+    if( anderson_.empty() )
     {
-        std::cout << "Iteration: " << iteration << "\t";
-        std::cout << "Relative error: " << max_abs_rel_error << "\t";
-        std::cout << "Location cell: " << std::distance( cells_.begin(), max_it ) << "\t";
-        std::cout << "Value at cell: " << sum_sclflux << std::endl;
+        return;
+    }
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::FISSION_SOURCE );
+    std::vector<double> &shape = fission_shape_[ S ];
+    std::vector<double> &mixed = mixed_fission_shape_[ S ];
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        shape[ i ] = cells_[ i ].FissionSource<S>() / cur_fission_source_[ S ];
+    }
+    std::copy( shape.begin(), shape.end(), mixed.begin() );
+    // A mixture with a negative cell source is discarded for the plain power
+    // iterate, which is never negative
+    anderson_[ S ].Mix( mixed );
+    for( std::size_t i = 0; i != cells_.size(); i++ )
+    {
+        if( shape[ i ] > 0.0 )
+        {
+            cells_[ i ].ScaleFissionSource<S>( mixed[ i ] / shape[ i ] );
+        }
     }
-
-    return max_abs_rel_error < settings_.SclFluxTol();
 }
 
-// [Adjoint] Check if scalar flux is converged
-bool Slab::AdjScalarFluxConverged( unsigned int iteration )
+// Return the largest cell fission source change since the last call
+template<Sense S>
+double Slab::FissionSourceChange()
 {
-    std::vector<Cell>::iterator max_it = std::max_element( cells_.begin(), cells_.end(),
-            []( Cell &smaller, Cell &bigger )
-            {
-                if( smaller.AdjMaxAbsScalarFluxError() < bigger.AdjMaxAbsScalarFluxError() )
-                {
-                    return true;
-                }
-                else
-                {
-                    return false;
-                }
-            } );
-    double adj_max_abs_rel_error = std::fabs( max_it->AdjMaxAbsScalarFluxError() );
-    double adj_sum_sclflux = max_it->AdjMidpointAngularFluxReference().ScalarFluxReference().GroupSum();
-    if( iteration % settings_.ProgressPeriod() == 0 )
+    std::vector<double> &prev = cell_fission_source_[ S ];
+    double max_source = 0.0;
+    double max_change = 0.0;
+    for( std::size_t i = 0; i != cells_.size(); i++ )
     {
-        std::cout << "Iteration: " << iteration << "\t";
-        std::cout << "Relative error: " << adj_max_abs_rel_error << "\t";
-        std::cout << "Location cell: " << std::distance( cells_.begin(), max_it ) << "\t";
-        std::cout << "Value at cell: " << adj_sum_sclflux << std::endl;
+        const double source = cells_[ i ].FissionSource<S>() / cur_fission_source_[ S ];
+        max_source = std::max( max_source, source );
+        max_change = std::max( max_change, std::fabs( source - prev[ i ] ) );
+        prev[ i ] = source;
     }
+    return max_source > 0.0 ? max_change / max_source : 0.0;
+}
 
-    return adj_max_abs_rel_error < settings_.SclFluxTol();
+// Return the scalar flux tolerance of the next inner iterations
+template<Sense S>
+double Slab::InnerTolerance() const
+{
+    const double tol = settings_.SclFluxTol();
+    if( !settings_.AdaptiveInnerTol() )
+    {
+        return tol;
+    }
+    return std::max( tol, settings_.InnerTolRatio() * outer_change_[ S ] );
 }
 
-// Calculate new cell scatter sources
-void Slab::UpdateScatterSources()
+// Return the sum of the cell fission sources
+template<Sense S>
+double Slab::TotalFissionSource()
 {
-    std::for_each( cells_.begin(), cells_.end(),
-            []( Cell &c )
+    // Summed by fixed blocks of cells, so that k does not depend on the number
+    // of threads
+    return fission_source_sums_[ S ].Sum( *thread_pools_[ S ],
+            [this]( std::size_t i )
             {
-                c.UpdateMidpointScatteringSource();
+                return cells_[ i ].FissionSource<S>();
             } );
 }
 
-// [Adjoint] Calculate new cell scatter sources
-void Slab::AdjUpdateScatterSources()
+// Check if scalar flux is converged
+template<Sense S>
+bool Slab::ScalarFluxConverged( unsigned int iteration, double tolerance )
 {
-    std::for_each( cells_.begin(), cells_.end(),
-            []( Cell &c )
+    // Find first cell with the largest error, evaluating each cell once. Each
+    // chunk finds its first, then the first of the chunks is taken.
+    std::vector<Cell>::iterator max_it = cells_.begin();
+    double max_rel_error;
+    {
+        Profile::ScopedTimer timer( *profile_[ S ], Profile::SCALAR_FLUX_CONVERGENCE );
+        std::vector<double> &errors = chunk_errors_[ S ];
+        std::vector<std::size_t> &max_cells = chunk_cells_[ S ];
+        thread_pools_[ S ]->ParallelFor( cells_.size(),
+                [this, &errors, &max_cells]( unsigned int chunk, std::size_t begin, std::size_t end )
+                {
+                    double max_error = -std::numeric_limits<double>::infinity();
+                    std::size_t max_cell = begin;
+                    for( std::size_t i = begin; i != end; i++ )
+                    {
+                        double rel_error = cells_[ i ].MaxAbsScalarFluxError<S>();
+                        if( max_error < rel_error )
+                        {
+                            max_error = rel_error;
+                            max_cell = i;
+                        }
+                    }
+                    errors[ chunk ] = max_error;
+                    max_cells[ chunk ] = max_cell;
+                } );
+        max_rel_error = errors.front();
+        max_it = cells_.begin() + max_cells.front();
+        for( std::size_t chunk = 1; chunk != errors.size(); chunk++ )
+        {
+            if( max_rel_error < errors[ chunk ] )
             {
-                c.AdjUpdateMidpointScatteringSource();
-            } );
+                max_rel_error = errors[ chunk ];
+                max_it = cells_.begin() + max_cells[ chunk ];
+            }
+        }
+    }
+    double max_abs_rel_error = std::fabs( max_rel_error );
+    if( iteration % settings_.ProgressPeriod() == 0 )
+    {
+        Profile::ScopedTimer timer( *profile_[ S ], Profile::OUTPUT );
+        std::ostream &out = *stream_[ S ];
+        const std::vector<double> &scl_flux = max_it->ScalarFluxValues<S>();
+        double sum_sclflux = std::accumulate( scl_flux.begin(), scl_flux.end(), 0.0 );
+        out << "Iteration: " << iteration << "\t";
+        out << "Relative error: " << max_abs_rel_error << "\t";
+        out << "Location cell: " << std::distance( cells_.begin(), max_it ) << "\t";
+        out << "Value at cell: " << sum_sclflux << std::endl;
+    }
+
+    return max_abs_rel_error < tolerance;
 }
 
-// Calcualte new cell fission sources
-void Slab::UpdateFissionSources()
+// Calculate new cell scatter sources
+template<Sense S>
+void Slab::UpdateScatterSources()
 {
-    std::for_each( cells_.begin(), cells_.end(),
-            []( Cell &c )
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::SCATTER_SOURCE );
+    thread_pools_[ S ]->ParallelFor( cells_.size(),
+            [this]( unsigned int, std::size_t begin, std::size_t end )
             {
-                c.UpdateMidpointFissionSource();
+                std::for_each( cells_.begin() + begin, cells_.begin() + end,
+                        []( Cell &c )
+                        {
+                            c.UpdateMidpointScatteringSource<S>();
+                        } );
             } );
 }
 
-// Calcualte new cell fission sources
-void Slab::AdjUpdateFissionSources()
+// Calculate new cell fission sources
+template<Sense S>
+void Slab::UpdateFissionSources()
 {
-    std::for_each( cells_.begin(), cells_.end(),
-            []( Cell &c )
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::FISSION_SOURCE );
+    const double k = cur_k_[ S ];
+    thread_pools_[ S ]->ParallelFor( cells_.size(),
+            [this, k]( unsigned int, std::size_t begin, std::size_t end )
             {
-                c.AdjUpdateMidpointFissionSource();
+                std::for_each( cells_.begin() + begin, cells_.begin() + end,
+                        [k]( Cell &c )
+                        {
+                            c.UpdateMidpointFissionSource<S>( k );
+                        } );
             } );
 }
 
 // Print scalar fluxes
+template<Sense S>
 void Slab::PrintScalarFluxes()
 {
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::OUTPUT );
+    std::ostream &out = *stream_[ S ];
     for( auto energy_it = energy_groups_.begin(); energy_it != energy_groups_.end(); energy_it++ )
     {
-        std::cout << "#sn_scalar_flux_group_" << *energy_it << "_ev" << std::endl;
-        for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
+        out << "#" << Prefix<S>() << "sn_scalar_flux_group_" << *energy_it << "_ev" << std::endl;
+        for( std::size_t i = 0; i != NumOutputCells(); i++ )
         {
-            std::cout << cell_it->MidpointAngularFluxReference().ScalarFluxReference().at( *energy_it );
-            if( cell_it == prev( cells_.end() ) )
+            out << OutputCell( i ).ScalarFluxAt<S>( *energy_it );
+            if( i + 1 == NumOutputCells() )
             {
-                std::cout << std::endl;
+                out << std::endl;
             }
             else
             {
-                std::cout << ",";
+                out << ",";
             }
         }
-        std::cout << "#end" << std::endl;
-    }
-}
-
-// [Adjoint] Print scalar fluxes
-void Slab::AdjPrintScalarFluxes()
-{
-    for( auto energy_it = energy_groups_.begin(); energy_it != energy_groups_.end(); energy_it++ )
-    {
-        std::cout << "#adj_sn_scalar_flux_group_" << *energy_it << "_ev" << std::endl;
-        for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
-        {
-            std::cout << cell_it->AdjMidpointAngularFluxReference().ScalarFluxReference().at( *energy_it );
-            if( cell_it == prev( cells_.end() ) )
-            {
-                std::cout << std::endl;
-            }
-            else
-            {
-                std::cout << ",";
-            }
-        }
-        std::cout << "#end" << std::endl;
+        out << "#end" << std::endl;
     }
 }
 
 // Print angular fluxes
+template<Sense S>
 void Slab::PrintAngularFluxes()
 {
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::OUTPUT );
+    std::ostream &out = *stream_[ S ];
+    ReconstructAngularFluxes<S>();
     for( auto energy_it = energy_groups_.begin(); energy_it != energy_groups_.end(); energy_it++ )
     {
-        std::cout << "#sn_angular_flux_group_" << *energy_it << "_ev" << std::endl;
-        for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
-        {
-            std::cout << cell_it->MidpointAngularFluxReference().at( *energy_it );
-        }
-        std::cout << "#end" << std::endl;
-    }
-}
-
-// Print angular fluxes
-void Slab::AdjPrintAngularFluxes()
-{
-    for( auto energy_it = energy_groups_.begin(); energy_it != energy_groups_.end(); energy_it++ )
-    {
-        std::cout << "#adj_sn_angular_flux_group_" << *energy_it << "_ev" << std::endl;
-        for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
+        out << "#" << Prefix<S>() << "sn_angular_flux_group_" << *energy_it << "_ev" << std::endl;
+        for( std::size_t i = 0; i != NumOutputCells(); i++ )
         {
-            std::cout << cell_it->AdjMidpointAngularFluxReference().at( *energy_it );
+            // Mirror images travel along the opposite ordinates
+            OutputCell( i ).MidpointAngularFluxReference<S>().PrintGroup( out, *energy_it, i >= cells_.size() );
         }
-        std::cout << "#end" << std::endl;
+        out << "#end" << std::endl;
     }
+    ReleaseAngularFluxes<S>();
 }
 
 // Print neutron densities
+template<Sense S>
 void Slab::PrintNeutronDensities()
 {
+    Profile::ScopedTimer timer( *profile_[ S ], Profile::OUTPUT );
+    std::ostream &out = *stream_[ S ];
     for( auto energy_it = energy_groups_.begin(); energy_it != energy_groups_.end(); energy_it++ )
     {
-        std::cout << "#sn_neutron_density_group_" << *energy_it << "_ev" << std::endl;
-        for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
+        out << "#" << Prefix<S>() << "sn_neutron_density_group_" << *energy_it << "_ev" << std::endl;
+        for( std::size_t i = 0; i != NumOutputCells(); i++ )
         {
-            std::cout << cell_it->MidpointAngularFluxReference().ScalarFluxReference().at( *energy_it ) / speeds_.at( *energy_it );
-            cell_it == prev( cells_.end() ) ? std::cout << std::endl : std::cout << ",";
+            out << OutputCell( i ).ScalarFluxAt<S>( *energy_it ) / speeds_.at( *energy_it );
+            i + 1 == NumOutputCells() ? out << std::endl : out << ",";
         }
-        std::cout << "#end" << std::endl;
-    }
-}
-
-// [Adjoint] Print neutron densities
-void Slab::AdjPrintNeutronDensities()
-{
-    for( auto energy_it = energy_groups_.begin(); energy_it != energy_groups_.end(); energy_it++ )
-    {
-        std::cout << "#adj_sn_neutron_density_group_" << *energy_it << "_ev" << std::endl;
-        for( auto cell_it = cells_.begin(); cell_it != cells_.end(); cell_it++ )
-        {
-            std::cout << cell_it->AdjMidpointAngularFluxReference().ScalarFluxReference().at( *energy_it ) / speeds_.at( *energy_it );
-            cell_it == prev( cells_.end() ) ? std::cout << std::endl : std::cout << ",";
-        }
-        std::cout << "#end" << std::endl;
+        out << "#end" << std::endl;
     }
 }
 
@@ -4,21 +4,32 @@
 #pragma once
 
 // std includes
+#include <cstddef>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
 #include <set>
 
 // biscotti includes
+#include "anderson.hpp"
+#include "blocksum.hpp"
 #include "cell.hpp"
+#include "diffusion.hpp"
 #include "layout.hpp"
+#include "profile.hpp"
 #include "settings.hpp"
+#include "sweepkernel.hpp"
+#include "threadpool.hpp"
 
 class Slab
 {
     public:
 
-        // Default constructor
-        Slab( const Settings &settings, const Layout &layout );
+        // Default constructor. If mirrored, the layout is the left half of a
+        // slab symmetric about its right boundary, which must be reflecting,
+        // and results are printed for the full slab.
+        Slab( const Settings &settings, const Layout &layout, bool mirrored = false );
 
         // Solve for k eigenvalue
         void EigenvalueSolve();
@@ -26,6 +37,32 @@ class Slab
         // [Adjoint] Solve for k eigenvalue
         void AdjEigenvalueSolve();
 
+        // Solve forward and adjoint k eigenvalue problems together, sweeping
+        // both in the same pass over the cells
+        void FusedEigenvalueSolve();
+
+        // Solve forward and adjoint k eigenvalue problems concurrently on two
+        // threads. Output of each is printed once both have finished.
+        void ConcurrentEigenvalueSolve();
+
+        // Solve for k eigenvalue on a mesh adapted to the scalar flux. Each
+        // refinement level starts from the solution of the previous one, and
+        // the scalar flux of the final mesh is printed with its cell widths.
+        void AdaptiveEigenvalueSolve();
+
+        // Solve for k eigenvalue on meshes coarsened from the segment cells,
+        // halving the coarsening from mesh to mesh. Each mesh starts from the
+        // angular flux and k of the previous one, the last being the cells of
+        // the slab.
+        void MeshSequencedEigenvalueSolve();
+
+        // Solve for k eigenvalue by Newton's method on the scalar flux and k,
+        // solving each Newton step by GMRES with Jacobian vector products
+        // differenced from residuals, each a single sweep, and preconditioned
+        // by diffusion. The left boundary must be vacuum, scattering isotropic
+        // and the spatial scheme flat within cells.
+        void JfnkEigenvalueSolve();
+
         // Solve for fission source matrix
         void FissionMatrixSolve();
 
@@ -35,78 +72,219 @@ class Slab
         // Solve for the fission source
         void FissionSourceSolve();
 
+        // Print memory used per cell and by the shared materials
+        void MemoryReport();
+
+        // Solve for k eigenvalue with angular fluxes stored in double and in
+        // single precision and print the differences in k and scalar flux
+        void PrecisionReport();
+
+        // Return memory used by cells, including those of angular multigrid
+        // levels (bytes)
+        std::size_t MemoryUsage() const;
+
+        // Accessors and mutators //
+
+        // Return current k eigenvalue
+        double KEigenvalue() const { return cur_k_[ FORWARD ]; };
+
+        // [Adjoint] Return current k eigenvalue
+        double AdjKEigenvalue() const { return cur_k_[ ADJOINT ]; };
+
+        // Return number of transport sweeps (source iterations) performed so
+        // far, forward and adjoint combined. Each sweep updates every ordinate
+        // of every group in every cell once.
+        unsigned long NumSweeps() const { return num_sweeps_[ FORWARD ] + num_sweeps_[ ADJOINT ]; };
+
+        // Return number of sweeps on lower order quadratures made by angular
+        // multigrid so far, forward and adjoint combined
+        unsigned long NumLowOrderSweeps() const { return num_low_order_sweeps_[ FORWARD ] + num_low_order_sweeps_[ ADJOINT ]; };
+
+        // Return number of cells
+        unsigned int NumCells() const { return cells_.size(); };
+
+        // Return number of energy groups
+        unsigned int NumGroups() const { return energy_groups_.size(); };
+
         // Friend functions //
- 
+
         // Overload operator<<()
         friend std::ostream &operator<< ( std::ostream &out, const Slab &obj );
 
     private:
 
+        // Solve for k eigenvalue. If warm_start, the flux and k already hold a
+        // guess consistent with each other: no diffusion guess is made and at
+        // least one outer iteration is performed even if the k eigenvalue is
+        // already converged.
+        template<Sense S>
+        void SolveEigenvalue( bool warm_start = false );
+
+        // Replace the flat guesses of sense S with the solution of the
+        // diffusion eigenvalue problem on the cells, unless disabled or the
+        // sense has been swept already. Return true if they were replaced.
+        template<Sense S>
+        bool DiffusionGuess();
+
+        // Replace the flux of sense S with the midpoint angular flux of a
+        // coarser slab of the same extent, projected onto the cells, and take
+        // over its k
+        template<Sense S>
+        void ProlongFrom( Slab &coarse );
+
+        // Recompute the fission source of sense S from the current flux and k
+        // as the reference of the next k update
+        template<Sense S>
+        void ResetFissionSource();
+
         // Solve for fixed source
+        template<Sense S>
         void FixedSourceSolve();
 
-        // [Adjoint] Solve for fixed source
-        void AdjFixedSourceSolve();
+        // Solve for k eigenvalue by Jacobian free Newton Krylov
+        template<Sense S>
+        void SolveJfnkEigenvalue();
+
+        // Write the Newton residual of x, the scalar flux of each cell over
+        // flux_scale followed by k, to residual: x less the scalar flux of one
+        // sweep from the sources of x over flux_scale, followed by the
+        // shortfall of the fission production of x relative to production. The
+        // cells are left holding the sweep.
+        template<Sense S>
+        void NewtonResidual( const std::vector<double> &x, double flux_scale, double production,
+                std::vector<double> &residual );
+
+        // Add to the scalar flux of x the diffusion estimate of the error a
+        // sweep would leave of it, with its scattering source written to
+        // source. The k of x is left as it is.
+        template<Sense S>
+        void DiffusionPrecondition( Diffusion &diffusion, std::vector<double> &source, std::vector<double> &x );
+
+        // Sweep all cells right from the left boundary, impose the right
+        // boundary condition and sweep all cells back left
+        template<Sense S>
+        void TransportSweep();
+
+        // Correct the scalar flux of sense S after a sweep with the error
+        // estimated on the next lower order quadrature, or by diffusion below
+        // the lowest order, if angular multigrid is selected. Return the number
+        // of lower order sweeps made.
+        template<Sense S>
+        unsigned long Accelerate();
+
+        // Estimate the scalar flux error of a higher order sweep driven by the
+        // external sources with one sweep from zero, corrected in turn by the
+        // levels below. Return the number of sweeps made on this and lower
+        // order quadratures.
+        template<Sense S>
+        unsigned long SolveCorrection();
 
         // Impose left boundary condition
+        template<Sense S>
         void ImposeLeftBC();
 
-        // [Adjoint] Impose left boundary condition
-        void AdjImposeLeftBC();
+        // Impose left boundary condition on the edge flux
+        template<Sense S>
+        void ImposeEdgeLeftBC();
+
+        // Impose right boundary condition
+        template<Sense S>
+        void ImposeRightBC();
 
-        // Sweep right
-        void SweepRight();
+        // Impose right boundary condition on the edge flux
+        template<Sense S>
+        void ImposeEdgeRightBC();
 
-        // [Adjoint] Sweep right
-        void AdjSweepRight();
+        // Impose right boundary condition on an angular flux leaving the right
+        // boundary, turning it into the incoming flux
+        template<Sense S>
+        void RightBoundaryFlux( AngularFlux &angflux ) const;
 
-        // Sweep left
-        void SweepLeft();
+        // Sweep through cells in direction D
+        template<Sense S, Direction D>
+        void Sweep();
 
-        // [Adjoint] Sweep left
-        void AdjSweepLeft();
+        // Sweep the edge flux through all cells in direction D
+        template<Sense S, Direction D>
+        void EdgeSweep();
+
+        // Sweep forward and adjoint edge fluxes through all cells in direction
+        // D in a single pass
+        template<Direction D>
+        void EdgeFusedSweep();
+
+        // Rebuild the midpoint and outgoing angular fluxes of all cells if only
+        // edge fluxes are stored
+        template<Sense S>
+        void ReconstructAngularFluxes();
+
+        // Free angular fluxes rebuilt by ReconstructAngularFluxes()
+        template<Sense S>
+        void ReleaseAngularFluxes();
+
+        // Sweep forward and adjoint through cells in direction D in a single pass
+        template<Direction D>
+        void FusedSweep();
 
         // Check if k eigenvalue is converged. If not, create new fission source.
+        template<Sense S>
         bool KConverged();
 
-        // [Adjoint] Check if k eigenvalue is converged. If not, create new fission source.
-        bool AdjKConverged();
+        // Replace the cell fission sources of sense S with their Anderson
+        // mixture with those of previous outer iterations, keeping the total
+        template<Sense S>
+        void MixFissionSources();
+
+        // Return the largest change of a cell fission source, relative to the
+        // total, since the last call, divided by the largest cell fission source
+        template<Sense S>
+        double FissionSourceChange();
+
+        // Return the scalar flux tolerance of the inner iterations of the next
+        // outer iteration: the scalar flux tolerance, or with an adaptive inner
+        // tolerance the inner tolerance ratio times the change of the last
+        // outer iteration if that is looser
+        template<Sense S>
+        double InnerTolerance() const;
 
-        // Check if scalar flux is converged
-        bool ScalarFluxConverged( unsigned int iteration );
+        // Return the sum of the cell fission sources of sense S
+        template<Sense S>
+        double TotalFissionSource();
 
-        // [Adjoint] Check if scalar flux is converged
-        bool AdjScalarFluxConverged( unsigned int iteration );
+        // Check if scalar flux is converged to tolerance
+        template<Sense S>
+        bool ScalarFluxConverged( unsigned int iteration, double tolerance );
 
         // Calculate new cell scatter sources
+        template<Sense S>
         void UpdateScatterSources();
 
-        // [Adjoint] Calculate new cell scatter sources
-        void AdjUpdateScatterSources();
-
         // Calculate new cell fission sources
+        template<Sense S>
         void UpdateFissionSources();
 
-        // [Adjoint] Calculate new cell fission sources
-        void AdjUpdateFissionSources();
-
         // Print scalar fluxes
+        template<Sense S>
         void PrintScalarFluxes();
 
-        // [Adjoint] Print scalar fluxes
-        void AdjPrintScalarFluxes();
-
         // Print angular fluxes
+        template<Sense S>
         void PrintAngularFluxes();
 
-        // [Adjoint] Print angular fluxes
-        void AdjPrintAngularFluxes();
-
         // Print neutron densities
+        template<Sense S>
         void PrintNeutronDensities();
 
-        // [Adjoint] Print neutron densities
-        void AdjPrintNeutronDensities();
+        // Number of cells results are printed for, including mirror images
+        std::size_t NumOutputCells() const { return mirrored_ ? 2 * cells_.size() : cells_.size(); };
+
+        // Cell at index of the printed cells. Past the solved cells come their
+        // mirror images in reverse order.
+        Cell &OutputCell( std::size_t index ) { return cells_[ index < cells_.size() ? index : NumOutputCells() - 1 - index ]; };
+
+        // Prefix of output tokens for sense S
+        template<Sense S>
+        static std::string Prefix() { return S == FORWARD ? "" : "adj_"; };
 
         // Const Settings
         const Settings settings_;
@@ -114,38 +292,106 @@ class Slab
         // Const Layout
         const Layout layout_;
 
-        // Current k eigenvalue
-        double cur_k_;
+        // True if the cells are the left half of a mirror symmetric slab
+        const bool mirrored_;
 
-        // [Adjoint] Current k eigenvalue
-        double adj_cur_k_;
+        // Current k eigenvalue (forward and adjoint)
+        double cur_k_[ 2 ];
 
-        // Previous k eigenvalue
-        double prev_k_;
+        // Previous k eigenvalue (forward and adjoint)
+        double prev_k_[ 2 ];
 
-        // [Adjoint] Previous k eigenvalue
-        double adj_prev_k_;
+        // Current fission source (forward and adjoint)
+        double cur_fission_source_[ 2 ];
 
-        // Current fission source
-        double cur_fission_source_;
+        // Previous fission source (forward and adjoint)
+        double prev_fission_source_[ 2 ];
 
-        // [Adjoint] Current fission source
-        double adj_cur_fission_source_;
+        // Change of the last outer iteration: the larger of the relative k
+        // change and the fission source change (forward and adjoint)
+        double outer_change_[ 2 ];
 
-        // Previous fission source
-        double prev_fission_source_;
+        // Cell fission sources of the last outer iteration relative to their
+        // total, empty without an adaptive inner tolerance (forward and
+        // adjoint)
+        std::vector<double> cell_fission_source_[ 2 ];
 
-        // [Adjoint] Previous fission source
-        double adj_prev_fission_source_;
+        // Anderson mixing of the cell fission sources relative to their total
+        // (forward and adjoint), empty at an Anderson depth of 0
+        std::vector<Anderson> anderson_;
+
+        // Cell fission sources relative to their total before and after
+        // Anderson mixing (forward and adjoint)
+        std::vector<double> fission_shape_[ 2 ];
+        std::vector<double> mixed_fission_shape_[ 2 ];
 
         // Vector of cells
         std::vector<Cell> cells_;
 
+        // Scratch incoming angular flux for the boundary conditions (forward
+        // and adjoint)
+        std::vector<AngularFlux> bnd_angflux_;
+
+        // Running edge angular flux of sweeps if only edge fluxes are stored
+        // (forward and adjoint). Between sweeps it holds the flux leaving the
+        // left boundary.
+        std::vector<AngularFlux> edge_angflux_;
+
+        // Scratch midpoint angular flux of sweeps if only edge fluxes are
+        // stored (forward and adjoint)
+        std::vector<AngularFlux> mid_angflux_;
+
         // Set of energy groups for problem
         const std::set<double> energy_groups_;
 
         // Corresponding speeds for each energy group
         GroupDependent speeds_;
+
+        // Sweep kernels specialized for the quadrature order and number of groups
+        const SweepKernels sweep_kernels_;
+
+        // Progress and output stream (forward and adjoint)
+        std::ostream *stream_[ 2 ];
+
+        // Number of transport sweeps performed (forward and adjoint)
+        unsigned long num_sweeps_[ 2 ];
+
+        // Phase timers and iteration counters (forward and adjoint)
+        Profile profiles_[ 2 ];
+
+        // Profile each sense is timed into (forward and adjoint)
+        Profile *profile_[ 2 ];
+
+        // Slab on the next lower order quadrature estimating the error of each
+        // sweep, null without angular multigrid or at its lowest order
+        std::unique_ptr<Slab> correction_;
+
+        // Diffusion problem of the error of each sweep at the lowest angular
+        // multigrid order (forward and adjoint), empty otherwise
+        std::vector<Diffusion> diffusion_;
+
+        // Scattering source of the change of the last sweep, per cell slowest
+        // group first (forward and adjoint), empty without angular multigrid
+        std::vector<double> error_source_[ 2 ];
+
+        // Scratch scalar flux of one cell (forward and adjoint)
+        std::vector<double> cell_sclflux_[ 2 ];
+
+        // Number of sweeps made on lower order quadratures (forward and
+        // adjoint)
+        unsigned long num_low_order_sweeps_[ 2 ];
+
+        // Threads the per cell loops are split over (forward and adjoint),
+        // one pool per sense so that concurrent solves do not share one
+        std::unique_ptr<ThreadPool> thread_pools_[ 2 ];
+
+        // Sums of the cell fission sources (forward and adjoint)
+        std::vector<BlockSum> fission_source_sums_;
+
+        // Largest scalar flux error and its cell of each chunk of the per cell
+        // loops (forward and adjoint)
+        std::vector<double> chunk_errors_[ 2 ];
+        std::vector<std::size_t> chunk_cells_[ 2 ];
 };
 
 // Friend functions //
@@ -0,0 +1,461 @@
+// sweepkernel.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// biscotti includes
+#include "sweepkernel.hpp"
+
+// Diamond difference update of a single group with A swept ordinates. The
+// midpoint flux solves
+//
+//     ( 1 + c sigma ) psi_mid = psi_in + c q,   c = h / ( 2 |mu| )
+//
+// where q = S / 2 is the isotropic source per unit ordinate weight, and the
+// outgoing flux is psi_out = 2 psi_mid - psi_in. Fluxes stored as T are
+// widened to double before use.
+template<unsigned int A, typename T>
+inline void DiamondDifferenceGroup( double width, const double *inv_mu, double source, double tot_xsec,
+        const T *in, T *mid, T *out )
+{
+    const double half_width = 0.5 * width;
+    const double half_source = 0.5 * source;
+    for( unsigned int a = 0; a != A; a++ )
+    {
+        const double c = half_width * inv_mu[ a ];
+        const double psi_in = in[ a ];
+        const double m = ( psi_in + c * half_source ) / ( 1.0 + c * tot_xsec );
+        mid[ a ] = T( m );
+        out[ a ] = T( 2.0 * m - psi_in );
+    }
+}
+
+// Fused forward and adjoint diamond difference update of a single group. The
+// coefficient c and cross section are shared, adjoint ordinates are traversed
+// in reverse so both halves see the same ordinate magnitude.
+template<unsigned int A, typename T>
+inline void FusedDiamondDifferenceGroup( double width, const double *inv_mu, double tot_xsec,
+        double source, const T *in, T *mid, T *out,
+        double adj_source, const T *adj_in, T *adj_mid, T *adj_out )
+{
+    const double half_width = 0.5 * width;
+    const double half_source = 0.5 * source;
+    const double adj_half_source = 0.5 * adj_source;
+    for( unsigned int a = 0; a != A; a++ )
+    {
+        const double c = half_width * inv_mu[ a ];
+        const double inv_denominator = 1.0 / ( 1.0 + c * tot_xsec );
+        const double psi_in = in[ a ];
+        const double m = ( psi_in + c * half_source ) * inv_denominator;
+        mid[ a ] = T( m );
+        out[ a ] = T( 2.0 * m - psi_in );
+        const unsigned int r = A - 1 - a;
+        const double adj_psi_in = adj_in[ r ];
+        const double adj_m = ( adj_psi_in + c * adj_half_source ) * inv_denominator;
+        adj_mid[ r ] = T( adj_m );
+        adj_out[ r ] = T( 2.0 * adj_m - adj_psi_in );
+    }
+}
+
+// Number of ordinates whose angular sources are built at a time by the
+// kernels that support source moments
+static const unsigned int source_block = 64;
+
+// Write the angular source of count swept ordinates of group g, starting at
+// ordinate first, to q: the isotropic source q0 = S / 2 plus the
+// moment-to-discrete product of the source moments. Each moment adds a scaled
+// matrix row, a loop that vectorizes across the ordinates.
+template<typename T>
+inline void OrdinateSources( const SweepArguments<T> &args, unsigned int g, unsigned int first, unsigned int count,
+        double half_source, double *q )
+{
+    for( unsigned int a = 0; a != count; a++ )
+    {
+        q[ a ] = half_source;
+    }
+    for( unsigned int l = 0; l != args.num_moments; l++ )
+    {
+        const double moment = args.moment_source[ l * args.num_groups + g ];
+        const double *row = args.moment_to_discrete + l * args.stride + first;
+        for( unsigned int a = 0; a != count; a++ )
+        {
+            q[ a ] += row[ a ] * moment;
+        }
+    }
+}
+
+// Sweep kernel with compile-time number of ordinates (2 A) and groups (G)
+template<unsigned int A, unsigned int G, typename T>
+void DiamondDifferenceKernel( const SweepArguments<T> &args )
+{
+    for( unsigned int g = 0; g != G; g++ )
+    {
+        DiamondDifferenceGroup<A>( args.width, args.inv_mu, args.source[ g ], args.tot_xsec[ g ],
+                args.in + g * 2 * A, args.mid + g * 2 * A, args.out + g * 2 * A );
+    }
+}
+
+// Fused sweep kernel with compile-time number of ordinates (2 A) and groups (G)
+template<unsigned int A, unsigned int G, typename T>
+void FusedDiamondDifferenceKernel( const FusedSweepArguments<T> &args )
+{
+    const SweepArguments<T> &fwd = args.forward;
+    const SweepArguments<T> &adj = args.adjoint;
+    for( unsigned int g = 0; g != G; g++ )
+    {
+        FusedDiamondDifferenceGroup<A>( fwd.width, fwd.inv_mu, fwd.tot_xsec[ g ],
+                fwd.source[ g ], fwd.in + g * 2 * A, fwd.mid + g * 2 * A, fwd.out + g * 2 * A,
+                adj.source[ g ], adj.in + g * 2 * A, adj.mid + g * 2 * A, adj.out + g * 2 * A );
+    }
+}
+
+// Sweep kernel for any number of ordinates and groups
+template<typename T>
+void GenericDiamondDifferenceKernel( const SweepArguments<T> &args )
+{
+    const double half_width = 0.5 * args.width;
+    for( unsigned int g = 0; g != args.num_groups; g++ )
+    {
+        const double half_source = 0.5 * args.source[ g ];
+        const double tot_xsec = args.tot_xsec[ g ];
+        const T *in = args.in + g * args.stride;
+        T *mid = args.mid + g * args.stride;
+        T *out = args.out + g * args.stride;
+        for( unsigned int a = 0; a != args.num_angles; a++ )
+        {
+            const double c = half_width * args.inv_mu[ a ];
+            const double psi_in = in[ a ];
+            const double m = ( psi_in + c * half_source ) / ( 1.0 + c * tot_xsec );
+            mid[ a ] = T( m );
+            out[ a ] = T( 2.0 * m - psi_in );
+        }
+    }
+}
+
+// Fused sweep kernel for any number of ordinates and groups
+template<typename T>
+void GenericFusedDiamondDifferenceKernel( const FusedSweepArguments<T> &args )
+{
+    const SweepArguments<T> &fwd = args.forward;
+    const SweepArguments<T> &adj = args.adjoint;
+    const double half_width = 0.5 * fwd.width;
+    const unsigned int last = fwd.num_angles - 1;
+    for( unsigned int g = 0; g != fwd.num_groups; g++ )
+    {
+        const double tot_xsec = fwd.tot_xsec[ g ];
+        const double half_source = 0.5 * fwd.source[ g ];
+        const double adj_half_source = 0.5 * adj.source[ g ];
+        const T *in = fwd.in + g * fwd.stride;
+        T *mid = fwd.mid + g * fwd.stride;
+        T *out = fwd.out + g * fwd.stride;
+        const T *adj_in = adj.in + g * adj.stride;
+        T *adj_mid = adj.mid + g * adj.stride;
+        T *adj_out = adj.out + g * adj.stride;
+        for( unsigned int a = 0; a != fwd.num_angles; a++ )
+        {
+            const double c = half_width * fwd.inv_mu[ a ];
+            const double inv_denominator = 1.0 / ( 1.0 + c * tot_xsec );
+            const double psi_in = in[ a ];
+            const double m = ( psi_in + c * half_source ) * inv_denominator;
+            mid[ a ] = T( m );
+            out[ a ] = T( 2.0 * m - psi_in );
+            const double adj_psi_in = adj_in[ last - a ];
+            const double adj_m = ( adj_psi_in + c * adj_half_source ) * inv_denominator;
+            adj_mid[ last - a ] = T( adj_m );
+            adj_out[ last - a ] = T( 2.0 * adj_m - adj_psi_in );
+        }
+    }
+}
+
+// Diamond difference sweep kernel for a source with moments above P0. The
+// angular source of each ordinate replaces the isotropic q of
+// DiamondDifferenceGroup().
+template<typename T>
+void AnisotropicDiamondDifferenceKernel( const SweepArguments<T> &args )
+{
+    const double half_width = 0.5 * args.width;
+    double q[ source_block ];
+    for( unsigned int g = 0; g != args.num_groups; g++ )
+    {
+        const double half_source = 0.5 * args.source[ g ];
+        const double tot_xsec = args.tot_xsec[ g ];
+        for( unsigned int first = 0; first < args.num_angles; first += source_block )
+        {
+            const unsigned int count = std::min( source_block, args.num_angles - first );
+            const unsigned int index = g * args.stride + first;
+            const T *in = args.in + index;
+            T *mid = args.mid + index;
+            T *out = args.out + index;
+            OrdinateSources( args, g, first, count, half_source, q );
+            for( unsigned int a = 0; a != count; a++ )
+            {
+                const double c = half_width * args.inv_mu[ first + a ];
+                const double psi_in = in[ a ];
+                const double m = ( psi_in + c * q[ a ] ) / ( 1.0 + c * tot_xsec );
+                mid[ a ] = T( m );
+                out[ a ] = T( 2.0 * m - psi_in );
+            }
+        }
+    }
+}
+
+// Fused diamond difference kernel for a source with moments above P0. The
+// forward and adjoint halves have different angular sources, so they are swept
+// one after the other.
+template<typename T>
+void AnisotropicFusedDiamondDifferenceKernel( const FusedSweepArguments<T> &args )
+{
+    AnisotropicDiamondDifferenceKernel( args.forward );
+    AnisotropicDiamondDifferenceKernel( args.adjoint );
+}
+
+// Linear discontinuous update of any number of ordinates and groups. In the
+// cell coordinate s along the swept ordinate, running from -1 at the incoming
+// edge to 1 at the outgoing edge, the flux is psi_a + psi_b s and the source
+// q_a + q_b s. The moment equations with the upwind outgoing flux
+// psi_out = psi_a + psi_b are
+//
+//     ( 1 + tau ) psi_a + psi_b = psi_in + t q_a
+//     -3 psi_a + ( 3 + tau ) psi_b = t q_b - 3 psi_in,   t = h / |mu|,
+//
+// where tau = sigma t. The midpoint flux is the cell average psi_a, and the
+// weighted sum of psi_b is returned in the cell coordinate x, which runs
+// opposite to s for the negative ordinates. Source moments above P0 are carried
+// as cell averages, only the isotropic source has a linear moment.
+template<typename T>
+void LinearDiscontinuousKernel( const SweepArguments<T> &args )
+{
+    double q[ source_block ];
+    for( unsigned int g = 0; g != args.num_groups; g++ )
+    {
+        const double half_source = 0.5 * args.source[ g ];
+        const double half_source_slope = 0.5 * args.sign * args.source_slope[ g ];
+        const double tot_xsec = args.tot_xsec[ g ];
+        double slope_sum = 0.0;
+        for( unsigned int first = 0; first < args.num_angles; first += source_block )
+        {
+            const unsigned int count = std::min( source_block, args.num_angles - first );
+            const unsigned int index = g * args.stride + first;
+            const T *in = args.in + index;
+            T *mid = args.mid + index;
+            T *out = args.out + index;
+            OrdinateSources( args, g, first, count, half_source, q );
+            for( unsigned int a = 0; a != count; a++ )
+            {
+                const double t = args.width * args.inv_mu[ first + a ];
+                const double tau = t * tot_xsec;
+                const double psi_in = in[ a ];
+                const double rhs_a = psi_in + t * q[ a ];
+                const double rhs_b = t * half_source_slope - 3.0 * psi_in;
+                const double inv_det = 1.0 / ( 6.0 + tau * ( 4.0 + tau ) );
+                const double psi_a = ( ( 3.0 + tau ) * rhs_a - rhs_b ) * inv_det;
+                const double psi_b = ( 3.0 * rhs_a + ( 1.0 + tau ) * rhs_b ) * inv_det;
+                mid[ a ] = T( psi_a );
+                out[ a ] = T( psi_a + psi_b );
+                slope_sum += args.weights[ first + a ] * psi_b;
+            }
+        }
+        args.slope_sum[ g ] = args.sign * slope_sum;
+    }
+}
+
+// Fused linear discontinuous kernel. The forward and adjoint halves share no
+// work beyond the cross sections, so they are swept one after the other.
+template<typename T>
+void FusedLinearDiscontinuousKernel( const FusedSweepArguments<T> &args )
+{
+    LinearDiscontinuousKernel( args.forward );
+    LinearDiscontinuousKernel( args.adjoint );
+}
+
+// Step characteristic update of any number of ordinates and groups. With a flat
+// angular source q across the cell (S / 2 plus any source moments), the exact solution along the swept ordinate
+// attenuates the incoming flux by exp( -tau ) and relaxes toward q / sigma:
+//
+//     psi_out = exp( -tau ) psi_in + ( 1 - exp( -tau ) ) q / sigma
+//
+// and the midpoint flux is the cell average of that solution. All coefficients
+// are nonnegative, so the fluxes stay positive on optically thick cells, and
+// are precomputed per cell width so the kernel does no division or exp().
+template<typename T>
+void StepCharacteristicKernel( const SweepArguments<T> &args )
+{
+    double q[ source_block ];
+    for( unsigned int g = 0; g != args.num_groups; g++ )
+    {
+        const double half_source = 0.5 * args.source[ g ];
+        for( unsigned int first = 0; first < args.num_angles; first += source_block )
+        {
+            const unsigned int count = std::min( source_block, args.num_angles - first );
+            const unsigned int index = g * args.stride + first;
+            const T *in = args.in + index;
+            T *mid = args.mid + index;
+            T *out = args.out + index;
+            const double *out_in = args.out_in + index;
+            const double *out_source = args.out_source + index;
+            const double *mid_in = args.mid_in + index;
+            const double *mid_source = args.mid_source + index;
+            OrdinateSources( args, g, first, count, half_source, q );
+            for( unsigned int a = 0; a != count; a++ )
+            {
+                const double psi_in = in[ a ];
+                mid[ a ] = T( mid_in[ a ] * psi_in + mid_source[ a ] * q[ a ] );
+                out[ a ] = T( out_in[ a ] * psi_in + out_source[ a ] * q[ a ] );
+            }
+        }
+    }
+}
+
+// Fused step characteristic kernel. The forward and adjoint halves read
+// different coefficients, so they are swept one after the other.
+template<typename T>
+void FusedStepCharacteristicKernel( const FusedSweepArguments<T> &args )
+{
+    StepCharacteristicKernel( args.forward );
+    StepCharacteristicKernel( args.adjoint );
+}
+
+// Row of specialized kernels for groups 2 through 8 at a fixed order
+#define BISCOTTI_KERNEL_ROW( K, A, T ) \
+    { K<A,2,T>, K<A,3,T>, K<A,4,T>, K<A,5,T>, K<A,6,T>, K<A,7,T>, K<A,8,T> }
+
+// Specialized kernels for angular fluxes stored as T, indexed by order (S8,
+// S16, S32, S64) and groups (2-8)
+static const unsigned int min_specialized_groups = 2;
+static const unsigned int max_specialized_groups = 8;
+template<typename T>
+struct SpecializedKernels
+{
+    static const SweepKernel<T> single[ 4 ][ 7 ];
+    static const FusedSweepKernel<T> fused[ 4 ][ 7 ];
+};
+template<typename T>
+const SweepKernel<T> SpecializedKernels<T>::single[ 4 ][ 7 ] =
+{
+    BISCOTTI_KERNEL_ROW( DiamondDifferenceKernel, 4, T ),
+    BISCOTTI_KERNEL_ROW( DiamondDifferenceKernel, 8, T ),
+    BISCOTTI_KERNEL_ROW( DiamondDifferenceKernel, 16, T ),
+    BISCOTTI_KERNEL_ROW( DiamondDifferenceKernel, 32, T )
+};
+template<typename T>
+const FusedSweepKernel<T> SpecializedKernels<T>::fused[ 4 ][ 7 ] =
+{
+    BISCOTTI_KERNEL_ROW( FusedDiamondDifferenceKernel, 4, T ),
+    BISCOTTI_KERNEL_ROW( FusedDiamondDifferenceKernel, 8, T ),
+    BISCOTTI_KERNEL_ROW( FusedDiamondDifferenceKernel, 16, T ),
+    BISCOTTI_KERNEL_ROW( FusedDiamondDifferenceKernel, 32, T )
+};
+
+#undef BISCOTTI_KERNEL_ROW
+
+// Return index into specialized kernel table for order, or -1 if none
+static int SpecializedOrderIndex( unsigned int order )
+{
+    switch( order )
+    {
+        case 8: return 0;
+        case 16: return 1;
+        case 32: return 2;
+        case 64: return 3;
+        default: return -1;
+    }
+}
+
+// Return the sweep kernels of a spatial scheme for a quadrature order and
+// number of groups
+SweepKernels SelectSweepKernels( Settings::Scheme scheme, unsigned int order, unsigned int num_groups,
+        bool anisotropic )
+{
+    SweepKernels kernels;
+    if( scheme == Settings::LINEAR_DISCONTINUOUS )
+    {
+        kernels.single = LinearDiscontinuousKernel<double>;
+        kernels.fused = FusedLinearDiscontinuousKernel<double>;
+        kernels.float_single = LinearDiscontinuousKernel<float>;
+        kernels.float_fused = FusedLinearDiscontinuousKernel<float>;
+    }
+    else if( scheme == Settings::STEP_CHARACTERISTIC )
+    {
+        kernels.single = StepCharacteristicKernel<double>;
+        kernels.fused = FusedStepCharacteristicKernel<double>;
+        kernels.float_single = StepCharacteristicKernel<float>;
+        kernels.float_fused = FusedStepCharacteristicKernel<float>;
+    }
+    else if( anisotropic )
+    {
+        kernels.single = AnisotropicDiamondDifferenceKernel<double>;
+        kernels.fused = AnisotropicFusedDiamondDifferenceKernel<double>;
+        kernels.float_single = AnisotropicDiamondDifferenceKernel<float>;
+        kernels.float_fused = AnisotropicFusedDiamondDifferenceKernel<float>;
+    }
+    else if( IsSpecializedSweepKernel( scheme, order, num_groups, anisotropic ) )
+    {
+        int order_index = SpecializedOrderIndex( order );
+        const unsigned int group_index = num_groups - min_specialized_groups;
+        kernels.single = SpecializedKernels<double>::single[ order_index ][ group_index ];
+        kernels.fused = SpecializedKernels<double>::fused[ order_index ][ group_index ];
+        kernels.float_single = SpecializedKernels<float>::single[ order_index ][ group_index ];
+        kernels.float_fused = SpecializedKernels<float>::fused[ order_index ][ group_index ];
+    }
+    else
+    {
+        kernels.single = GenericDiamondDifferenceKernel<double>;
+        kernels.fused = GenericFusedDiamondDifferenceKernel<double>;
+        kernels.float_single = GenericDiamondDifferenceKernel<float>;
+        kernels.float_fused = GenericFusedDiamondDifferenceKernel<float>;
+    }
+    return kernels;
+}
+
+// Return true if SelectSweepKernels() has specialized kernels for the scheme
+// and sizes
+bool IsSpecializedSweepKernel( Settings::Scheme scheme, unsigned int order, unsigned int num_groups,
+        bool anisotropic )
+{
+    return scheme == Settings::DIAMOND_DIFFERENCE && !anisotropic &&
+        SpecializedOrderIndex( order ) >= 0 &&
+        num_groups >= min_specialized_groups &&
+        num_groups <= max_specialized_groups;
+}
+
+// Return the step characteristic coefficients of a cell of the given width.
+// The coefficients that divide by tau are evaluated with expm1() or, for small
+// tau, a series, so a void or optically thin cell reduces to
+// psi_out = psi_in + t q and psi_mid = psi_in + t q / 2 with t = h / |mu|.
+std::vector<double> StepCharacteristicCoefficients( double width, const std::vector<double> &tot_xsec,
+        const std::vector<double> &inv_mu )
+{
+    const std::size_t block = tot_xsec.size() * inv_mu.size();
+    std::vector<double> coefficients( 4 * block );
+    for( std::size_t g = 0; g != tot_xsec.size(); g++ )
+    {
+        for( std::size_t a = 0; a != inv_mu.size(); a++ )
+        {
+            const double t = width * inv_mu[ a ];
+            const double tau = t * tot_xsec[ g ];
+            const double absorbed = -std::expm1( -tau );
+            // ( 1 - exp( -tau ) ) / tau and ( tau - 1 + exp( -tau ) ) / tau^2
+            double escape;
+            double average;
+            if( tau >= 1.0e-2 )
+            {
+                escape = absorbed / tau;
+                average = ( tau - absorbed ) / ( tau * tau );
+            }
+            else
+            {
+                escape = 1.0 - tau * ( 0.5 - tau * ( 1.0 / 6.0 - tau * ( 1.0 / 24.0 - tau / 120.0 ) ) );
+                average = 0.5 - tau * ( 1.0 / 6.0 - tau * ( 1.0 / 24.0 - tau * ( 1.0 / 120.0 - tau / 720.0 ) ) );
+            }
+            const std::size_t index = g * inv_mu.size() + a;
+            coefficients[ index ] = std::exp( -tau );
+            coefficients[ block + index ] = t * escape;
+            coefficients[ 2 * block + index ] = escape;
+            coefficients[ 3 * block + index ] = t * average;
+        }
+    }
+    return coefficients;
+}
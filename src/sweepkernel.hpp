@@ -0,0 +1,172 @@
+// sweepkernel.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <vector>
+
+// biscotti includes
+#include "settings.hpp"
+
+// Sense of a transport problem
+enum Sense
+{
+    FORWARD,
+    ADJOINT
+};
+
+// Direction of a sweep through the slab
+enum Direction
+{
+    RIGHT,
+    LEFT
+};
+
+// Sweep policy. The adjoint problem streams opposite to the forward problem,
+// so forward sweeps to the right and adjoint sweeps to the left travel along
+// the positive ordinates and the rest travel along the negative ordinates.
+template<Sense S, Direction D>
+struct SweepPolicy
+{
+    // True if sweep travels along the positive ordinates
+    static const bool positive = ( S == FORWARD ) == ( D == RIGHT );
+
+    // Direction of the following sweep in a source iteration
+    static const Direction reverse = D == RIGHT ? LEFT : RIGHT;
+};
+
+// Arguments to a single cell sweep over one half of the ordinates. Angular flux
+// pointers point to the first swept ordinate of the slowest group; consecutive
+// groups are stride values apart. Angular fluxes are stored as T, arithmetic is
+// done in double.
+template<typename T>
+struct SweepArguments
+{
+    // Number of energy groups
+    unsigned int num_groups;
+
+    // Number of swept ordinates per group (half the quadrature order)
+    unsigned int num_angles;
+
+    // Distance between consecutive groups (the quadrature order)
+    unsigned int stride;
+
+    // Cell width
+    double width;
+
+    // Reciprocal magnitude of each swept ordinate
+    const double *inv_mu;
+
+    // Total isotropic source per group
+    const double *source;
+
+    // Macroscopic total cross section per group
+    const double *tot_xsec;
+
+    // Incoming angular flux
+    const T *in;
+
+    // Midpoint angular flux
+    T *mid;
+
+    // Outgoing angular flux
+    T *out;
+
+    // Linear discontinuous scheme only //
+
+    // Linear moment of the total isotropic source per group
+    const double *source_slope;
+
+    // Sign of the swept ordinates (+1 positive, -1 negative)
+    double sign;
+
+    // Quadrature weight of each swept ordinate
+    const double *weights;
+
+    // Weighted sum of the linear moment of the swept ordinates per group
+    // (written by the kernel)
+    double *slope_sum;
+
+    // Step characteristic scheme only //
+
+    // Coefficients of each swept ordinate per group, laid out like the angular
+    // fluxes. With tau = sigma h / |mu| these are exp( -tau ) and
+    // ( 1 - exp( -tau ) ) / sigma for the incoming flux and source in the
+    // outgoing flux, and ( 1 - exp( -tau ) ) / tau and
+    // ( tau - 1 + exp( -tau ) ) / ( sigma tau ) for those in the midpoint flux.
+    const double *out_in;
+    const double *out_source;
+    const double *mid_in;
+    const double *mid_source;
+
+    // Anisotropic scattering only //
+
+    // Number of source moments above P0 (zero for an isotropic source)
+    unsigned int num_moments;
+
+    // Moments 1 through num_moments of the source per group, one block of
+    // groups per moment
+    const double *moment_source;
+
+    // Moment-to-discrete matrix of the swept ordinates, one row per moment,
+    // rows stride values apart (see Quadrature::MomentToDiscrete())
+    const double *moment_to_discrete;
+};
+
+// Arguments to a fused forward and adjoint sweep of a single cell in the same
+// direction. The two halves travel opposite ordinates, so the adjoint swept
+// ordinates are in reverse order of magnitude relative to the forward ones.
+template<typename T>
+struct FusedSweepArguments
+{
+    // Forward sweep
+    SweepArguments<T> forward;
+
+    // Adjoint sweep
+    SweepArguments<T> adjoint;
+};
+
+// Sweep of a single cell
+template<typename T>
+using SweepKernel = void (*)( const SweepArguments<T> &args );
+
+// Fused forward and adjoint sweep of a single cell
+template<typename T>
+using FusedSweepKernel = void (*)( const FusedSweepArguments<T> &args );
+
+// Kernels selected for a problem size
+struct SweepKernels
+{
+    // Forward or adjoint sweep
+    SweepKernel<double> single;
+
+    // Fused forward and adjoint sweep
+    FusedSweepKernel<double> fused;
+
+    // Forward or adjoint sweep of angular fluxes stored in single precision
+    SweepKernel<float> float_single;
+
+    // Fused forward and adjoint sweep of angular fluxes stored in single
+    // precision
+    FusedSweepKernel<float> float_fused;
+};
+
+// Return the sweep kernels of a spatial scheme for a quadrature order and
+// number of groups, with or without anisotropic source moments. Isotropic
+// diamond difference at common sizes uses kernels with compile-time trip
+// counts, everything else uses generic kernels.
+SweepKernels SelectSweepKernels( Settings::Scheme scheme, unsigned int order, unsigned int num_groups,
+        bool anisotropic );
+
+// Return true if SelectSweepKernels() has specialized kernels for the scheme
+// and sizes
+bool IsSpecializedSweepKernel( Settings::Scheme scheme, unsigned int order, unsigned int num_groups,
+        bool anisotropic );
+
+// Return the step characteristic coefficients of a cell of the given width for
+// each group's total cross section and each ordinate's reciprocal magnitude:
+// four blocks of num_groups * order values in the order of the SweepArguments
+// fields, each laid out like an angular flux
+std::vector<double> StepCharacteristicCoefficients( double width, const std::vector<double> &tot_xsec,
+        const std::vector<double> &inv_mu );
@@ -0,0 +1,94 @@
+// threadpool.cpp
+// Aaron G. Tumulak
+
+// std includes
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// biscotti includes
+#include "threadpool.hpp"
+
+// Start num_threads - 1 threads to run alongside the caller
+ThreadPool::ThreadPool( unsigned int num_threads ):
+    generation_( 0 ),
+    pending_( 0 ),
+    stop_( false ),
+    task_( nullptr ),
+    function_( nullptr ),
+    size_( 0 )
+{
+    for( unsigned int chunk = 1; chunk < num_threads; chunk++ )
+    {
+        threads_.emplace_back( &ThreadPool::Work, this, chunk );
+    }
+}
+
+// Stop and join the threads
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        stop_ = true;
+    }
+    start_.notify_all();
+    for( auto it = threads_.begin(); it != threads_.end(); it++ )
+    {
+        it->join();
+    }
+}
+
+// Run task on each chunk of [0, size)
+void ThreadPool::Run( std::size_t size, Task task, const void *function )
+{
+    // Without threads the loop is called directly, as a single chunk
+    if( threads_.empty() )
+    {
+        task( function, 0, 0, size );
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        task_ = task;
+        function_ = function;
+        size_ = size;
+        pending_ = threads_.size();
+        generation_++;
+    }
+    start_.notify_all();
+    RunChunk( 0 );
+    std::unique_lock<std::mutex> lock( mutex_ );
+    done_.wait( lock, [this]{ return pending_ == 0; } );
+}
+
+// Run the current task on chunk
+void ThreadPool::RunChunk( unsigned int chunk )
+{
+    const std::size_t num_chunks = threads_.size() + 1;
+    task_( function_, chunk, size_ * chunk / num_chunks, size_ * ( chunk + 1 ) / num_chunks );
+}
+
+// Body of the thread running chunk
+void ThreadPool::Work( unsigned int chunk )
+{
+    unsigned long generation = 0;
+    while( true )
+    {
+        {
+            std::unique_lock<std::mutex> lock( mutex_ );
+            start_.wait( lock, [this, generation]{ return stop_ || generation_ != generation; } );
+            if( stop_ )
+            {
+                return;
+            }
+            generation = generation_;
+        }
+        RunChunk( chunk );
+        std::lock_guard<std::mutex> lock( mutex_ );
+        if( --pending_ == 0 )
+        {
+            done_.notify_one();
+        }
+    }
+}
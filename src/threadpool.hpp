@@ -0,0 +1,89 @@
+// threadpool.hpp
+// Aaron G. Tumulak
+
+#pragma once
+
+// std includes
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent threads running loops over index ranges in parallel. Each loop is
+// split statically into one contiguous chunk per thread, chunk 0 being run by
+// the calling thread, so that a chunk covers the same indices every time. The
+// threads sleep between loops. A pool runs one loop at a time and must only be
+// used from one thread.
+class ThreadPool
+{
+    public:
+
+        // Start num_threads - 1 threads to run alongside the caller
+        explicit ThreadPool( unsigned int num_threads );
+
+        // Stop and join the threads
+        ~ThreadPool();
+
+        ThreadPool( const ThreadPool & ) = delete;
+        ThreadPool &operator=( const ThreadPool & ) = delete;
+
+        // Call function( chunk, begin, end ) for each chunk [begin, end) of
+        // [0, size) and return once all have returned. Chunks may be empty.
+        template<class Function>
+        void ParallelFor( std::size_t size, const Function &function );
+
+        // Accessors and mutators //
+
+        // Return number of threads, including the caller, which is also the
+        // number of chunks of a loop
+        unsigned int NumThreads() const { return threads_.size() + 1; };
+
+    private:
+
+        // Type-erased function of a loop, called with the function itself
+        typedef void ( *Task )( const void *function, unsigned int chunk, std::size_t begin, std::size_t end );
+
+        // Run task on each chunk of [0, size)
+        void Run( std::size_t size, Task task, const void *function );
+
+        // Run the current task on chunk
+        void RunChunk( unsigned int chunk );
+
+        // Body of the thread running chunk
+        void Work( unsigned int chunk );
+
+        // Threads running chunks 1 and up
+        std::vector<std::thread> threads_;
+
+        // Guards everything below
+        std::mutex mutex_;
+
+        // Signalled when a loop starts or the pool stops, and when the last
+        // thread finishes its chunk
+        std::condition_variable start_;
+        std::condition_variable done_;
+
+        // Number of loops started, threads yet to finish the current one, and
+        // true once the pool is stopping
+        unsigned long generation_;
+        unsigned int pending_;
+        bool stop_;
+
+        // Current loop
+        Task task_;
+        const void *function_;
+        std::size_t size_;
+};
+
+// Call function on each chunk of [0, size)
+template<class Function>
+void ThreadPool::ParallelFor( std::size_t size, const Function &function )
+{
+    Run( size,
+            []( const void *f, unsigned int chunk, std::size_t begin, std::size_t end )
+            {
+                ( *static_cast<const Function *>( f ) )( chunk, begin, end );
+            },
+            &function );
+}